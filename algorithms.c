@@ -6,165 +6,203 @@
 #include "graph.h"        
 #include "ui.h"           // <-- for UI output (route header etc.)
 #include "algorithms.h"   
+#include "compact.h"
+#include "components.h"
+#include "route.h"
+#include "fuzzy.h"
+
+
+// ---------- Menu route queries (thin clients of the route engine) ----------
+static void runRouteQuery(const char* start, const char* end, int method) {
+    static SearchWorkspace ws;
+    static int wsReady = 0;
+    if (!wsReady) {
+        initWorkspace(&ws);
+        wsReady = 1;
+    }
 
-
-#define INF INT_MAX
-
-// ---------- BFS Shortest Path ----------
-void bfsShortestPath(const char* start, const char* end) {
-    int s = getCityIndex(start);
-    int e = getCityIndex(end);
+    /* names resolve against the handle; typos fall back to fuzzy matches */
+    const RouteGraph* g = currentRouteGraph();
+    int s = resolveRouteCity(g, start);
+    int e = resolveRouteCity(g, end);
     if (s == -1 || e == -1) {
         printf("Invalid city name.\n");
         return;
     }
+    start = g->names[s];
+    end = g->names[e];
 
-    int visited[MAX] = {0}, parent[MAX];
-    for (int i = 0; i < MAX; i++) parent[i] = -1;
-
-    int queue[MAX], front = 0, rear = 0;
-    visited[s] = 1;
-    queue[rear++] = s;
-
-    while (front < rear) {
-        int curr = queue[front++];
-        Node* temp = adjList[curr];
-        while (temp) {
-            int next = temp->cityIndex;
-            if (!visited[next]) {
-                visited[next] = 1;
-                parent[next] = curr;
-                queue[rear++] = next;
-            }
-            temp = temp->next;
-        }
-    }
-
-    if (!visited[e]) {
-        printf("No path found from %s to %s.\n", start, end);
+    RouteResult r;
+    if (!sameComponent(s, e) || !routeQuery(g, s, e, method, &ws, &r)) {
+        if (method == ROUTE_FEWEST_HOPS) printf("No path found from %s to %s.\n", start, end);
+        else printf("No route from %s to %s.\n", start, end);
         return;
     }
 
-    int path[MAX], pathLen = 0;
-    for (int v = e; v != -1; v = parent[v]) path[pathLen++] = v;
+    if (method == ROUTE_FEWEST_HOPS) printf("\nShortest Path (Least Hops - BFS):\n");
+    else printf("\nShortest Path (Dijkstra - Weighted):\n");
+    displayRoute(g, &r);
+    showRouteSummary(&r);
+}
 
-    printf("\nShortest Path (Least Hops - BFS):\n");
-    displayRoute(path, pathLen);
-    showRouteSummary(path, pathLen);
+// ---------- BFS Shortest Path ----------
+void bfsShortestPath(const char* start, const char* end) {
+    runRouteQuery(start, end, ROUTE_FEWEST_HOPS);
 }
 
 // ---------- Dijkstra Shortest Path ----------
 void dijkstraShortestPath(const char* start, const char* end) {
-    int s = getCityIndex(start);
-    int e = getCityIndex(end);
-    if (s == -1 || e == -1) {
-        printf("Invalid city name.\n");
+    runRouteQuery(start, end, ROUTE_SHORTEST);
+}
+
+// ---------- Unified Route Display ----------
+void displayRoute(const RouteGraph* g, const RouteResult* r) {
+    if (r->stops <= 0) {
+        printf("No route available.\n");
         return;
     }
 
-    int dist[MAX], visited[MAX] = {0}, parent[MAX];
-    for (int i = 0; i < cityCount; i++) {
-        dist[i] = INF;
-        parent[i] = -1;
+    printf("Route: ");
+    for (int i = 0; i < r->stops; i++) {
+        printf("%s", g->names[r->path[i]]);
+        if (i < r->stops - 1) printf(" ---> ");
     }
+    printf("\n");
 
-    dist[s] = 0;
+    printf("Total Distance: %d km\n", r->total);
+    printf("=============================\n");
+}
 
-    for (int i = 0; i < cityCount - 1; i++) {
-        int minDist = INF, u = -1;
-        for (int j = 0; j < cityCount; j++) {
-            if (!visited[j] && dist[j] < minDist) {
-                minDist = dist[j];
-                u = j;
-            }
-        }
-        if (u == -1) break;
-        visited[u] = 1;
-
-        Node* temp = adjList[u];
-        while (temp) {
-            int v = temp->cityIndex;
-            if (!visited[v] && dist[u] + temp->distance < dist[v]) {
-                dist[v] = dist[u] + temp->distance;
-                parent[v] = u;
-            }
-            temp = temp->next;
-        }
-    }
 
-    if (dist[e] == INF) {
-        printf("No route from %s to %s.\n", start, end);
+
+//route summary
+
+void showRouteSummary(const RouteResult* r) {
+    if (r->stops <= 0) {
+        printf("No route to display.\n");
         return;
     }
 
-    int path[MAX], pathLen = 0;
-    for (int v = e; v != -1; v = parent[v]) path[pathLen++] = v;
+    int totalLegs = r->stops - 1;
+    double avgDistance = (totalLegs > 0) ? (double)r->total / totalLegs : 0.0;
 
-    printf("\nShortest Path (Dijkstra - Weighted):\n");
-    displayRoute(path, pathLen);
-    showRouteSummary(path, pathLen);
+    printf("\n========= ROUTE SUMMARY =========\n");
+    printf("Total Stops (including start & end): %d\n", r->stops);
+    printf("Number of Legs (roads travelled): %d\n", totalLegs);
+    printf("Total Distance: %d km\n", r->total);
+    printf("Average Distance per Leg: %.2f km\n", avgDistance);
+    printf("=================================\n");
 }
 
-// ---------- Unified Route Display ----------
-void displayRoute(int path[], int pathLen) {
-    if (pathLen <= 0) {
-        printf("No route available.\n");
-        return;
+
+
+// ---------- City list input ----------
+/* parse "A, B, C" into distinct city indices of g (typos resolved
+   fuzzily). Returns the count, or -1 after reporting an unknown name. */
+int parseCityList(const RouteGraph* g, const char* list, int out[], int maxOut) {
+    char buf[MAX * NAME_LEN];
+    int count = 0;
+
+    strncpy(buf, list, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    for (char* tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        while (*tok == ' ') tok++;
+        char* end = tok + strlen(tok);
+        while (end > tok && end[-1] == ' ') *--end = '\0';
+        if (*tok == '\0') continue;
+
+        int idx = resolveRouteCity(g, tok);
+        if (idx == -1) {
+            printf("Invalid city name: %s\n", tok);
+            return -1;
+        }
+
+        int seen = 0;
+        for (int i = 0; i < count; i++) {
+            if (out[i] == idx) seen = 1;
+        }
+        if (!seen && count < maxOut) out[count++] = idx;
     }
+    return count;
+}
 
-    printf("Route: ");
-    for (int i = pathLen - 1; i >= 0; i--) {
-        printf("%s", cities[path[i]].name);
-        if (i > 0) printf(" ---> ");
+// ---------- Bounded multi-source search (isochrone) ----------
+/* every city within `budget` km of any source, streamed to emit() in
+   increasing distance order. Returns the number of cities reached. */
+int rangeQuery(const RouteGraph* g, SearchWorkspace* ws, const int sources[], int sourceCount,
+               int budget, RangeWriter emit, void* ctx) {
+    int reached = 0;
+
+    workspaceBegin(ws);
+    for (int i = 0; i < sourceCount; i++) {
+        if (sources[i] >= 0 && sources[i] < g->cityCount && workspaceDist(ws, sources[i]) != 0)
+            workspacePush(ws, sources[i], 0, -1, 0);
     }
-    printf("\n");
 
-    int totalDist = 0;
-    for (int i = pathLen - 1; i > 0; i--) {
-        Node* temp = adjList[path[i]];
-        while (temp) {
-            if (temp->cityIndex == path[i - 1]) {
-                totalDist += temp->distance;
-                break;
-            }
-            temp = temp->next;
+    while (ws->heapSize > 0) {
+        int u = workspacePop(ws);
+        int du = ws->dist[u];
+        if (du > budget) break;
+
+        emit(u, du, ctx);
+        reached++;
+
+        CompactCursor cur;
+        int v, w;
+        compactBegin(&cur, &g->adj, u);
+        while (compactNext(&cur, &v, &w)) {
+            int nd = du + w;
+            if (nd > budget || workspaceSettled(ws, v) || nd >= workspaceDist(ws, v)) continue;
+            workspacePush(ws, v, nd, u, w);
         }
     }
+    return reached;
+}
 
-    printf("Total Distance: %d km\n", totalDist);
-    printf("=============================\n");
+/* RangeWriter that appends "city<TAB>distance" lines to a RangeReport */
+void writeRangeHit(int city, int dist, void* ctx) {
+    RangeReport* report = (RangeReport*)ctx;
+    fprintf(report->fp, "%s\t%d\n", report->g->names[city], dist);
 }
 
+/* prints each hit and streams it into the report file */
+static void reportRangeHit(int city, int dist, void* ctx) {
+    RangeReport* report = (RangeReport*)ctx;
+    printf("  %-*s %d km\n", NAME_LEN, report->g->names[city], dist);
+    writeRangeHit(city, dist, ctx);
+}
 
+/* menu front-end: sources as a comma-separated list of city names */
+void citiesWithinRange(const char* sourceList, int budget) {
+    static SearchWorkspace ws;
+    static int wsReady = 0;
+    int sources[MAX], sourceCount;
 
-//route summary
+    if (!wsReady) {
+        initWorkspace(&ws);
+        wsReady = 1;
+    }
 
-void showRouteSummary(const int path[], int pathLen) {
-    if (pathLen <= 0) {
-        printf("No route to display.\n");
+    const RouteGraph* g = currentRouteGraph();
+    sourceCount = parseCityList(g, sourceList, sources, MAX);
+    if (sourceCount < 0) return;
+    if (sourceCount == 0) {
+        printf("No source cities given.\n");
         return;
     }
 
-    int totalDistance = 0;
-    int totalLegs = pathLen - 1;
-
-    for (int i = 0; i < pathLen - 1; i++) {
-        Node* temp = adjList[path[i]];
-        while (temp) {
-            if (temp->cityIndex == path[i + 1]) {
-                totalDistance += temp->distance;
-                break;
-            }
-            temp = temp->next;
-        }
+    FILE* fp = fopen("last_isochrone.txt", "w");
+    if (!fp) {
+        printf("Failed to open last_isochrone.txt for writing.\n");
+        return;
     }
 
-    double avgDistance = (totalLegs > 0) ? (double)totalDistance / totalLegs : 0.0;
+    printf("\nCities within %d km of %s:\n", budget, sourceList);
+    fprintf(fp, "Isochrone Report\nSources: %s\nBudget: %d km\n", sourceList, budget);
+    RangeReport report = { g, fp };
+    int reached = rangeQuery(g, &ws, sources, sourceCount, budget, reportRangeHit, &report);
+    fclose(fp);
 
-    printf("\n========= ROUTE SUMMARY =========\n");
-    printf("Total Stops (including start & end): %d\n", pathLen);
-    printf("Number of Legs (roads travelled): %d\n", totalLegs);
-    printf("Total Distance: %d km\n", totalDistance);
-    printf("Average Distance per Leg: %.2f km\n", avgDistance);
-    printf("=================================\n");
+    printf("Reachable Cities: %d\n", reached);
+    printf("Isochrone saved to 'last_isochrone.txt'.\n");
 }
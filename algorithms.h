@@ -1,12 +1,31 @@
 #ifndef ALGORITHMS_H
 #define ALGORITHMS_H
 
+#include <stdio.h>
+
 #include "graph.h"
+#include "route.h"
 
 void bfsShortestPath(const char* start, const char* end);
 void dijkstraShortestPath(const char* start, const char* end);
-void displayRoute(int path[], int pathLen);
-void showRouteSummary(const int path[], int pathLen);
+void displayRoute(const RouteGraph* g, const RouteResult* r);
+void showRouteSummary(const RouteResult* r);
+
+int parseCityList(const RouteGraph* g, const char* list, int out[], int maxOut);
+
+/* receives each reached city in increasing distance order */
+typedef void (*RangeWriter)(int city, int dist, void* ctx);
+
+/* ctx for writeRangeHit: the handle the query ran on and the output file */
+typedef struct RangeReport {
+    const RouteGraph* g;
+    FILE* fp;
+} RangeReport;
+
+int rangeQuery(const RouteGraph* g, SearchWorkspace* ws, const int sources[], int sourceCount,
+               int budget, RangeWriter emit, void* ctx);
+void writeRangeHit(int city, int dist, void* ctx);
+void citiesWithinRange(const char* sourceList, int budget);
 
 
 #endif
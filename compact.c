@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph.h"
+#include "compact.h"
+
+/* build scratch: neighbours above / below each city */
+static int upperNbr[MAX][MAX], upperW[MAX][MAX], upperCount[MAX];
+static int lowerNbr[MAX][MAX], lowerRoad[MAX][MAX], lowerCount[MAX];
+static unsigned char scratch[MAX * MAX * 8];
+
+/* ------------------ varint helpers ------------------ */
+
+static void putVarint(unsigned char* buf, int* pos, unsigned int x) {
+    while (x >= 0x80) {
+        buf[(*pos)++] = (unsigned char)(x | 0x80);
+        x >>= 7;
+    }
+    buf[(*pos)++] = (unsigned char)x;
+}
+
+static unsigned int getVarint(const unsigned char* buf, int* pos) {
+    unsigned int x = 0;
+    int shift = 0;
+    unsigned char b;
+    do {
+        b = buf[(*pos)++];
+        x |= (unsigned int)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    return x;
+}
+
+static int readWeight(const CompactGraph* g, int road) {
+    const unsigned char* w = g->weights;
+    switch (g->weightBytes) {
+        case 1: return w[road];
+        case 2: return w[2 * road] | (w[2 * road + 1] << 8);
+        default: {
+            int x;
+            memcpy(&x, w + 4 * road, sizeof(int));
+            return x;
+        }
+    }
+}
+
+/* ------------------ build ------------------ */
+
+void buildCompactGraph(CompactGraph* g) {
+    int n = cityCount;
+    int minW = 0, maxW = 0, roads = 0;
+
+    g->upperStart = (int*)malloc((n + 1) * sizeof(int));
+    g->lowerStart = (int*)malloc((n + 1) * sizeof(int));
+    g->firstRoad = (int*)malloc((n + 1) * sizeof(int));
+
+    /* roads to higher ids, sorted */
+    for (int u = 0; u < n; u++) {
+        upperCount[u] = 0;
+        lowerCount[u] = 0;
+        for (Node* t = adjList[u]; t; t = t->next) {
+            if (t->cityIndex <= u) continue;
+            int j = upperCount[u]++;
+            while (j > 0 && upperNbr[u][j - 1] > t->cityIndex) {
+                upperNbr[u][j] = upperNbr[u][j - 1];
+                upperW[u][j] = upperW[u][j - 1];
+                j--;
+            }
+            upperNbr[u][j] = t->cityIndex;
+            upperW[u][j] = t->distance;
+        }
+    }
+
+    for (int u = 0; u < n; u++) {
+        g->firstRoad[u] = roads;
+        for (int i = 0; i < upperCount[u]; i++, roads++) {
+            int v = upperNbr[u][i];
+            lowerNbr[v][lowerCount[v]] = u;
+            lowerRoad[v][lowerCount[v]++] = roads;
+            if (upperW[u][i] < minW) minW = upperW[u][i];
+            if (upperW[u][i] > maxW) maxW = upperW[u][i];
+        }
+    }
+    g->firstRoad[n] = roads;
+    g->nodeCount = n;
+    g->roadCount = roads;
+
+    if (minW < 0 || maxW > 0xFFFF) g->weightBytes = 4;
+    else if (maxW > 0xFF) g->weightBytes = 2;
+    else g->weightBytes = 1;
+
+    /* id streams: all upper lists, then all reverse views */
+    int pos = 0;
+    for (int u = 0; u < n; u++) {
+        g->upperStart[u] = pos;
+        int prev = u;
+        for (int i = 0; i < upperCount[u]; i++) {
+            putVarint(scratch, &pos, upperNbr[u][i] - prev);
+            prev = upperNbr[u][i];
+        }
+    }
+    g->upperStart[n] = pos;
+
+    for (int u = 0; u < n; u++) {
+        g->lowerStart[u] = pos;
+        int prev = u, prevRoad = g->firstRoad[u];
+        for (int i = lowerCount[u] - 1; i >= 0; i--) {
+            putVarint(scratch, &pos, prev - lowerNbr[u][i]);
+            putVarint(scratch, &pos, prevRoad - lowerRoad[u][i]);
+            prev = lowerNbr[u][i];
+            prevRoad = lowerRoad[u][i];
+        }
+    }
+    g->lowerStart[n] = pos;
+
+    g->byteCount = pos;
+    g->bytes = (unsigned char*)malloc(pos > 0 ? pos : 1);
+    memcpy(g->bytes, scratch, pos);
+
+    g->weights = (unsigned char*)malloc(roads > 0 ? roads * g->weightBytes : 1);
+    for (int u = 0, k = 0; u < n; u++) {
+        for (int i = 0; i < upperCount[u]; i++, k++) {
+            int w = upperW[u][i];
+            if (g->weightBytes == 1) {
+                g->weights[k] = (unsigned char)w;
+            } else if (g->weightBytes == 2) {
+                g->weights[2 * k] = (unsigned char)(w & 0xFF);
+                g->weights[2 * k + 1] = (unsigned char)(w >> 8);
+            } else {
+                memcpy(g->weights + 4 * k, &w, sizeof(int));
+            }
+        }
+    }
+}
+
+void freeCompactGraph(CompactGraph* g) {
+    free(g->upperStart);
+    free(g->lowerStart);
+    free(g->firstRoad);
+    free(g->bytes);
+    free(g->weights);
+    g->upperStart = NULL;
+    g->lowerStart = NULL;
+    g->firstRoad = NULL;
+    g->bytes = NULL;
+    g->weights = NULL;
+}
+
+/* ------------------ memory accounting ------------------ */
+
+int compactGraphBytes(const CompactGraph* g) {
+    int index = 3 * (g->nodeCount + 1) * (int)sizeof(int);
+    return (int)sizeof(CompactGraph) + index + g->byteCount + g->roadCount * g->weightBytes;
+}
+
+int adjacencyListBytes(void) {
+    int nodes = 0;
+    for (int u = 0; u < cityCount; u++)
+        for (Node* t = adjList[u]; t; t = t->next) nodes++;
+    return (int)sizeof(adjList) + nodes * (int)sizeof(Node);   /* adjList is a fixed MAX array too */
+}
+
+/* ------------------ iteration ------------------ */
+
+void compactBegin(CompactCursor* c, const CompactGraph* g, int u) {
+    c->g = g;
+    c->u = u;
+    c->pos = g->upperStart[u];
+    c->prev = u;
+    c->road = g->firstRoad[u] - 1;
+    c->upper = 1;
+}
+
+/* next neighbour of c->u; returns 0 when exhausted */
+int compactNext(CompactCursor* c, int* v, int* weight) {
+    const CompactGraph* g = c->g;
+
+    if (c->upper) {
+        if (c->pos < g->upperStart[c->u + 1]) {
+            c->prev += (int)getVarint(g->bytes, &c->pos);
+            c->road++;
+            *v = c->prev;
+            *weight = readWeight(g, c->road);
+            return 1;
+        }
+        /* switch to the reverse view */
+        c->upper = 0;
+        c->pos = g->lowerStart[c->u];
+        c->prev = c->u;
+        c->road = g->firstRoad[c->u];
+    }
+
+    if (c->pos >= g->lowerStart[c->u + 1]) return 0;
+    c->prev -= (int)getVarint(g->bytes, &c->pos);
+    c->road -= (int)getVarint(g->bytes, &c->pos);
+    *v = c->prev;
+    *weight = readWeight(g, c->road);
+    return 1;
+}
@@ -0,0 +1,42 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include "graph.h"
+
+/* Read-only compressed adjacency.
+   Each road is stored once, under its lower-numbered city:
+     - neighbour ids as varint deltas (ascending, starting from the city)
+     - weights in the narrowest width that fits (1, 2 or 4 bytes)
+   The higher-numbered city reaches it through a reverse view holding
+   varint deltas of the neighbour id and of the road id. */
+typedef struct CompactGraph {
+    int nodeCount;
+    int roadCount;
+    int weightBytes;
+    int* upperStart;             /* nodeCount + 1: byte range of roads to higher ids */
+    int* lowerStart;             /* nodeCount + 1: byte range of the reverse view */
+    int* firstRoad;              /* nodeCount + 1: road id of each city's first upper road */
+    unsigned char* bytes;
+    int byteCount;
+    unsigned char* weights;
+} CompactGraph;
+
+/* iterates the neighbours of one city */
+typedef struct CompactCursor {
+    const CompactGraph* g;
+    int u;
+    int pos;
+    int prev;                    /* previously decoded neighbour */
+    int road;                    /* road id of the previous neighbour */
+    int upper;                   /* 1 while walking roads to higher ids */
+} CompactCursor;
+
+void buildCompactGraph(CompactGraph* g);
+void freeCompactGraph(CompactGraph* g);
+int compactGraphBytes(const CompactGraph* g);
+int adjacencyListBytes(void);
+
+void compactBegin(CompactCursor* c, const CompactGraph* g, int u);
+int compactNext(CompactCursor* c, int* v, int* weight);
+
+#endif
@@ -0,0 +1,84 @@
+#include <stdio.h>
+
+#include "graph.h"
+#include "components.h"
+
+static int ufParent[MAX];
+static int ufSize[MAX];
+static int dirty = 1;
+
+/* ------------------ union-find ------------------ */
+
+static int findRoot(int v) {
+    while (ufParent[v] != v) {
+        ufParent[v] = ufParent[ufParent[v]];   /* path halving */
+        v = ufParent[v];
+    }
+    return v;
+}
+
+static void unite(int a, int b) {
+    a = findRoot(a);
+    b = findRoot(b);
+    if (a == b) return;
+    if (ufSize[a] < ufSize[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    ufParent[b] = a;
+    ufSize[a] += ufSize[b];
+}
+
+static void rebuild(void) {
+    for (int v = 0; v < cityCount; v++) {
+        ufParent[v] = v;
+        ufSize[v] = 1;
+    }
+    for (int u = 0; u < cityCount; u++) {
+        for (Node* t = adjList[u]; t; t = t->next) {
+            if (u < t->cityIndex) unite(u, t->cityIndex);
+        }
+    }
+    dirty = 0;
+}
+
+/* ------------------ maintenance hooks ------------------ */
+
+void componentsOnCityAdded(int idx) {
+    if (dirty) return;
+    ufParent[idx] = idx;
+    ufSize[idx] = 1;
+}
+
+void componentsOnRoadAdded(int a, int b) {
+    if (!dirty) unite(a, b);
+}
+
+void componentsInvalidate(void) {
+    dirty = 1;
+}
+
+/* ------------------ queries ------------------ */
+
+int sameComponent(int a, int b) {
+    if (dirty) rebuild();
+    return findRoot(a) == findRoot(b);
+}
+
+/* fills sizes[] (largest first) and returns the number of components */
+int getComponentSizes(int sizes[]) {
+    int count = 0;
+    if (dirty) rebuild();
+
+    for (int v = 0; v < cityCount; v++) {
+        if (findRoot(v) != v) continue;
+        int j = count++;
+        while (j > 0 && sizes[j - 1] < ufSize[v]) {
+            sizes[j] = sizes[j - 1];
+            j--;
+        }
+        sizes[j] = ufSize[v];
+    }
+    return count;
+}
@@ -0,0 +1,15 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+/* Connected-component index (union-find).
+   Kept up to date incrementally as cities and roads are added; deletions
+   and renumbering mark it dirty and it is rebuilt on the next query. */
+
+void componentsOnCityAdded(int idx);
+void componentsOnRoadAdded(int a, int b);
+void componentsInvalidate(void);
+
+int sameComponent(int a, int b);
+int getComponentSizes(int sizes[]);
+
+#endif
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+
+#include "graph.h"
+#include "route.h"
+#include "fuzzy.h"
+
+/* per-city signatures, rebuilt when the map changes */
+static char lowered[MAX][NAME_LEN];
+static int nameLen[MAX];
+static uint64_t gramMask[MAX];
+static unsigned long signatureVersion = (unsigned long)-1;
+
+/* ------------------ helpers ------------------ */
+
+static int lowerCopy(char* dst, const char* src) {
+    int n = 0;
+    while (src[n] && n < NAME_LEN - 1) {
+        dst[n] = (char)tolower((unsigned char)src[n]);
+        n++;
+    }
+    dst[n] = '\0';
+    return n;
+}
+
+/* set of character bigrams hashed into 64 bits */
+static uint64_t bigramMask(const char* s, int len) {
+    uint64_t mask = 0;
+    for (int i = 0; i + 1 < len; i++) {
+        unsigned h = (unsigned char)s[i] * 31u + (unsigned char)s[i + 1];
+        mask |= 1ULL << (h & 63);
+    }
+    return mask;
+}
+
+static int popcount64(uint64_t x) {
+    int n = 0;
+    while (x) {
+        x &= x - 1;
+        n++;
+    }
+    return n;
+}
+
+static void refreshSignatures(void) {
+    if (signatureVersion == graphVersion) return;
+    for (int i = 0; i < cityCount; i++) {
+        nameLen[i] = lowerCopy(lowered[i], cities[i].name);
+        gramMask[i] = bigramMask(lowered[i], nameLen[i]);
+    }
+    signatureVersion = graphVersion;
+}
+
+/* ------------------ Myers bit-parallel edit distance ------------------ */
+
+/* Levenshtein distance between pattern p (m <= 64 chars, match table
+   peq) and text t. One column of the DP matrix per text character. */
+static int myersDistance(const uint64_t peq[256], int m, const char* t, int n) {
+    if (m == 0) return n;
+
+    uint64_t pv = ~0ULL, mv = 0;
+    uint64_t last = 1ULL << (m - 1);
+    int score = m;
+
+    for (int j = 0; j < n; j++) {
+        uint64_t eq = peq[(unsigned char)t[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & last) score++;
+        else if (mh & last) score--;
+
+        ph = (ph << 1) | 1;   /* row 0 grows by one per column */
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+static void buildPeq(uint64_t peq[256], const char* p, int m) {
+    memset(peq, 0, 256 * sizeof(uint64_t));
+    for (int i = 0; i < m; i++) peq[(unsigned char)p[i]] |= 1ULL << i;
+}
+
+/* case-insensitive edit distance of two names */
+int editDistance(const char* a, const char* b) {
+    char la[NAME_LEN], lb[NAME_LEN];
+    uint64_t peq[256];
+    int m = lowerCopy(la, a);
+    int n = lowerCopy(lb, b);
+
+    buildPeq(peq, la, m);
+    return myersDistance(peq, m, lb, n);
+}
+
+/* ------------------ lookup ------------------ */
+
+/* typos tolerated for a name of this length */
+int defaultMaxEdits(const char* name) {
+    int len = (int)strlen(name);
+    if (len <= 4) return 1;
+    if (len <= 8) return 2;
+    return 3;
+}
+
+/* a query prepared once and scored against many candidate names */
+typedef struct FuzzyQuery {
+    char q[NAME_LEN];
+    int m;
+    int maxEdits;
+    uint64_t mask;
+    int grams;
+    uint64_t peq[256];
+} FuzzyQuery;
+
+static void prepareQuery(FuzzyQuery* fq, const char* query, int maxEdits) {
+    fq->m = lowerCopy(fq->q, query);
+    fq->maxEdits = maxEdits;
+    fq->mask = bigramMask(fq->q, fq->m);
+    fq->grams = popcount64(fq->mask);
+    buildPeq(fq->peq, fq->q, fq->m);
+}
+
+/* edit distance to a lowered candidate, or -1 if it is more than maxEdits away */
+static int scoreCandidate(const FuzzyQuery* fq, const char* lowered, int len, uint64_t mask) {
+    /* each edit changes the length by at most one ... */
+    int diff = len - fq->m;
+    if (diff > fq->maxEdits || -diff > fq->maxEdits) return -1;
+    /* ... and destroys at most two of the query's bigrams */
+    if (popcount64(fq->mask & mask) < fq->grams - 2 * fq->maxEdits) return -1;
+
+    int d = myersDistance(fq->peq, fq->m, lowered, len);
+    return d > fq->maxEdits ? -1 : d;
+}
+
+/* insert candidate i at distance d into the closest-first top list */
+static int keepClosest(int i, int d, int out[], int dists[], int found, int maxOut) {
+    if (found == maxOut && d >= dists[maxOut - 1]) return found;
+
+    int j = (found < maxOut) ? found++ : maxOut - 1;
+    while (j > 0 && dists[j - 1] > d) {
+        out[j] = out[j - 1];
+        dists[j] = dists[j - 1];
+        j--;
+    }
+    out[j] = i;
+    dists[j] = d;
+    return found;
+}
+
+/* cities within maxEdits of query, closest first; returns the count */
+int fuzzyMatches(const char* query, int maxEdits, int out[], int dists[], int maxOut) {
+    FuzzyQuery fq;
+    int found = 0;
+
+    refreshSignatures();
+    prepareQuery(&fq, query, maxEdits);
+
+    for (int i = 0; i < cityCount; i++) {
+        int d = scoreCandidate(&fq, lowered[i], nameLen[i], gramMask[i]);
+        if (d >= 0) found = keepClosest(i, d, out, dists, found, maxOut);
+    }
+    return found;
+}
+
+/* same as fuzzyMatches, over the names of a route graph handle */
+int fuzzyMatchesIn(const RouteGraph* g, const char* query, int maxEdits,
+                   int out[], int dists[], int maxOut) {
+    FuzzyQuery fq;
+    int found = 0;
+
+    prepareQuery(&fq, query, maxEdits);
+    for (int i = 0; i < g->cityCount; i++) {
+        char name[NAME_LEN];
+        int len = lowerCopy(name, g->names[i]);
+        int d = scoreCandidate(&fq, name, len, bigramMask(name, len));
+        if (d >= 0) found = keepClosest(i, d, out, dists, found, maxOut);
+    }
+    return found;
+}
+
+/* pick the single closest match, or report a tie; names[i] belongs to match[i] */
+static int chooseMatch(const char* name, const char* const names[],
+                       const int match[], const int dist[], int found) {
+    if (found == 0) return -1;
+
+    if (found > 1 && dist[1] == dist[0]) {
+        printf("'%s' is ambiguous. Did you mean:", name);
+        for (int i = 0; i < found && dist[i] == dist[0]; i++) printf(" %s", names[i]);
+        printf("\n");
+        return -1;
+    }
+
+    printf("Using '%s' for '%s'.\n", names[0], name);
+    return match[0];
+}
+
+/* exact lookup, falling back to the single closest fuzzy match */
+int resolveCityName(const char* name) {
+    int idx = getCityIndex(name);
+    if (idx != -1) return idx;
+
+    int match[FUZZY_MAX_RESULTS], dist[FUZZY_MAX_RESULTS];
+    const char* names[FUZZY_MAX_RESULTS];
+    int found = fuzzyMatches(name, defaultMaxEdits(name), match, dist, FUZZY_MAX_RESULTS);
+    for (int i = 0; i < found; i++) names[i] = cities[match[i]].name;
+    return chooseMatch(name, names, match, dist, found);
+}
+
+/* resolveCityName against a route graph handle; indices are g's */
+int resolveRouteCity(const RouteGraph* g, const char* name) {
+    int idx = routeCityIndex(g, name);
+    if (idx != -1) return idx;
+
+    int match[FUZZY_MAX_RESULTS], dist[FUZZY_MAX_RESULTS];
+    const char* names[FUZZY_MAX_RESULTS];
+    int found = fuzzyMatchesIn(g, name, defaultMaxEdits(name), match, dist, FUZZY_MAX_RESULTS);
+    for (int i = 0; i < found; i++) names[i] = g->names[match[i]];
+    return chooseMatch(name, names, match, dist, found);
+}
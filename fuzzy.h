@@ -0,0 +1,21 @@
+#ifndef FUZZY_H
+#define FUZZY_H
+
+#include "route.h"
+
+/* Typo-tolerant city-name lookup.
+   Candidates are prefiltered by length and a 64-bit bigram signature,
+   then ranked by case-insensitive edit distance computed with Myers'
+   bit-parallel algorithm. */
+
+#define FUZZY_MAX_RESULTS 5
+
+int editDistance(const char* a, const char* b);
+int defaultMaxEdits(const char* name);
+int fuzzyMatches(const char* query, int maxEdits, int out[], int dists[], int maxOut);
+int fuzzyMatchesIn(const RouteGraph* g, const char* query, int maxEdits,
+                   int out[], int dists[], int maxOut);
+int resolveCityName(const char* name);
+int resolveRouteCity(const RouteGraph* g, const char* name);
+
+#endif
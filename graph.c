@@ -3,10 +3,16 @@
 #include <string.h>
 #include "graph.h"
 #include "ui.h" 
+#include "journal.h"
+#include "components.h"
+#include "spatial.h"
+#include "fuzzy.h"
+#include "route.h"
 
 City cities[MAX];
 int cityCount = 0;
 Node* adjList[MAX] = { NULL };
+unsigned long graphVersion = 0;   /* bumped on every topology change */
 
 /* ------------------ basic helpers ------------------ */
 
@@ -17,47 +23,28 @@ int getCityIndex(const char* name) {
     return -1;
 }
 
-/* Add a city */
-void addCity(const char* name) {
-    if (cityCount >= MAX) {
-        printError("Cannot add more cities. Limit reached.");
-        return;
-    }
-    // Optional: check for duplicates
-    for (int i = 0; i < cityCount; i++) {
-        if (strcmp(cities[i].name, name) == 0) {
-            printError("City already exists!");
-            return;
-        }
-    }
+/* ------------------ silent mutators (no output, no journaling) ------------------ */
+
+/* returns 1 if the city was added */
+int insertCity(const char* name) {
+    if (cityCount >= MAX || getCityIndex(name) != -1) return 0;
     strncpy(cities[cityCount].name, name, NAME_LEN);
     cities[cityCount].name[NAME_LEN-1] = '\0';
+    cities[cityCount].located = 0;
+    adjList[cityCount] = NULL;
+    componentsOnCityAdded(cityCount);
     cityCount++;
-    printSuccess("City added successfully!");
+    graphVersion++;
+    return 1;
 }
 
-
-/* Add a two-way road */
-void addRoad(const char* city1, const char* city2, int distance) {
-    int a = getCityIndex(city1);
-    int b = getCityIndex(city2);
-    if (a == -1 || b == -1) {
-        printf("Error: One or both cities not found.\n");
-        return;
-    }
-    if (a == b) {
-        printf("Cannot add road from a city to itself.\n");
-        return;
-    }
+/* returns 1 if the road a<->b was added */
+int insertRoad(int a, int b, int distance) {
+    if (a < 0 || a >= cityCount || b < 0 || b >= cityCount || a == b) return 0;
 
     /* Prevent duplicate edge a->b */
-    Node* t = adjList[a];
-    while (t) {
-        if (t->cityIndex == b) {
-            printf("Road already exists between '%s' and '%s'.\n", city1, city2);
-            return;
-        }
-        t = t->next;
+    for (Node* t = adjList[a]; t; t = t->next) {
+        if (t->cityIndex == b) return 0;
     }
 
     Node* n1 = (Node*)malloc(sizeof(Node));
@@ -72,30 +59,13 @@ void addRoad(const char* city1, const char* city2, int distance) {
     n2->next = adjList[b];
     adjList[b] = n2;
 
-    printf("Road added between '%s' and '%s' (%d km)\n", city1, city2, distance);
+    componentsOnRoadAdded(a, b);
+    graphVersion++;
+    return 1;
 }
 
-/* Display all connections */
-void displayGraph() {
-    printf("\n===== CITY MAP =====\n");
-    for (int i = 0; i < cityCount; i++) {
-        printf("%s -> ", cities[i].name);
-        Node* t = adjList[i];
-        if (!t) printf("(no connections)");
-        while (t) {
-            printf("%s (%dkm)", cities[t->cityIndex].name, t->distance);
-            t = t->next;
-            if (t) printf(", ");
-        }
-        printf("\n");
-    }
-    printf("====================\n");
-}
-
-/* ------------------ deletion helpers ------------------ */
-
-/* delete a single directed edge u->v from adjacency list */
-static void deleteDirectedEdgeIndex(int u, int v) {
+/* delete a single directed edge u->v from adjacency list; 1 if it existed */
+static int deleteDirectedEdgeIndex(int u, int v) {
     Node* cur = adjList[u];
     Node* prev = NULL;
     while (cur) {
@@ -103,34 +73,27 @@ static void deleteDirectedEdgeIndex(int u, int v) {
             if (prev) prev->next = cur->next;
             else adjList[u] = cur->next;
             free(cur);
-            return;
+            return 1;
         }
         prev = cur;
         cur = cur->next;
     }
+    return 0;
 }
 
-/* delete road both directions */
-void deleteRoad(const char* city1, const char* city2) {
-    int a = getCityIndex(city1);
-    int b = getCityIndex(city2);
-    if (a == -1 || b == -1) {
-        printf("Error: One or both cities not found.\n");
-        return;
+/* returns 1 if the road a<->b existed */
+int removeRoad(int a, int b) {
+    int found = deleteDirectedEdgeIndex(a, b);
+    found |= deleteDirectedEdgeIndex(b, a);
+    if (found) {
+        componentsInvalidate();
+        graphVersion++;
     }
-    deleteDirectedEdgeIndex(a, b);
-    deleteDirectedEdgeIndex(b, a);
-    printf("Road between '%s' and '%s' deleted (if existed).\n", city1, city2);
+    return found;
 }
 
 /* delete a city (and all edges). This will shift arrays to keep compact indices. */
-void deleteCity(const char* name) {
-    int idx = getCityIndex(name);
-    if (idx == -1) {
-        printf("City '%s' not found.\n", name);
-        return;
-    }
-
+void removeCity(int idx) {
     /* free adjacency list of idx */
     Node* cur = adjList[idx];
     while (cur) {
@@ -147,7 +110,6 @@ void deleteCity(const char* name) {
 
     /* shift cities and adjList left to fill removed index */
     for (int i = idx; i < cityCount - 1; i++) {
-        /* free current adjList[i] if any - we will reassign pointer */
         adjList[i] = adjList[i+1];
         cities[i] = cities[i+1];
     }
@@ -163,6 +125,109 @@ void deleteCity(const char* name) {
             p = p->next;
         }
     }
+    componentsInvalidate();
+    spatialInvalidate();
+    graphVersion++;
+}
+
+void locateCity(int idx, double x, double y) {
+    if (idx < 0 || idx >= cityCount) return;
+    cities[idx].x = x;
+    cities[idx].y = y;
+    cities[idx].located = 1;
+    spatialOnCityLocated(idx);
+}
+
+/* ------------------ user-facing mutators ------------------ */
+
+/* Add a city */
+void addCity(const char* name) {
+    if (cityCount >= MAX) {
+        printError("Cannot add more cities. Limit reached.");
+        return;
+    }
+    if (getCityIndex(name) != -1) {
+        printError("City already exists!");
+        return;
+    }
+    insertCity(name);
+    journalRecord(JOURNAL_ADD_CITY, name, NULL, 0);
+    printSuccess("City added successfully!");
+}
+
+
+/* Add a two-way road */
+void addRoad(const char* city1, const char* city2, int distance) {
+    int a = getCityIndex(city1);
+    int b = getCityIndex(city2);
+    if (a == -1 || b == -1) {
+        printf("Error: One or both cities not found.\n");
+        return;
+    }
+    if (a == b) {
+        printf("Cannot add road from a city to itself.\n");
+        return;
+    }
+    if (!insertRoad(a, b, distance)) {
+        printf("Road already exists between '%s' and '%s'.\n", city1, city2);
+        return;
+    }
+    journalRecord(JOURNAL_ADD_ROAD, city1, city2, distance);
+
+    printf("Road added between '%s' and '%s' (%d km)\n", city1, city2, distance);
+}
+
+/* Display all connections */
+void displayGraph() {
+    printf("\n===== CITY MAP =====\n");
+    for (int i = 0; i < cityCount; i++) {
+        printf("%s -> ", cities[i].name);
+        Node* t = adjList[i];
+        if (!t) printf("(no connections)");
+        while (t) {
+            printf("%s (%dkm)", cities[t->cityIndex].name, t->distance);
+            t = t->next;
+            if (t) printf(", ");
+        }
+        printf("\n");
+    }
+    printf("====================\n");
+}
+
+/* Place a city on the map */
+void setCityLocation(const char* name, double x, double y) {
+    int idx = getCityIndex(name);
+    if (idx == -1) {
+        printf("City '%s' not found.\n", name);
+        return;
+    }
+    locateCity(idx, x, y);
+    journalLocation(name, x, y);
+    printf("City '%s' placed at (%.4f, %.4f).\n", name, x, y);
+}
+
+/* ------------------ deletion ------------------ */
+
+/* delete road both directions */
+void deleteRoad(const char* city1, const char* city2) {
+    int a = getCityIndex(city1);
+    int b = getCityIndex(city2);
+    if (a == -1 || b == -1) {
+        printf("Error: One or both cities not found.\n");
+        return;
+    }
+    if (removeRoad(a, b)) journalRecord(JOURNAL_DELETE_ROAD, city1, city2, 0);
+    printf("Road between '%s' and '%s' deleted (if existed).\n", city1, city2);
+}
+
+void deleteCity(const char* name) {
+    int idx = getCityIndex(name);
+    if (idx == -1) {
+        printf("City '%s' not found.\n", name);
+        return;
+    }
+    removeCity(idx);
+    journalRecord(JOURNAL_DELETE_CITY, name, NULL, 0);
 
     printf("City '%s' and its roads deleted successfully.\n", name);
 }
@@ -244,14 +309,120 @@ void getGraphStats(int* totalCities, int* totalRoads, double* avgDistance, int*
     *mostConnectedIndex = mostConn;
 }
 
+/* ------------------ locality reordering ------------------ */
+
+static int degreeOf(int u) {
+    int deg = 0;
+    for (Node* t = adjList[u]; t; t = t->next) deg++;
+    return deg;
+}
+
+/* average |u - v| over all roads: lower means neighbours sit closer in memory */
+double averageIndexGap(void) {
+    long sum = 0;
+    int edges = 0;
+    for (int u = 0; u < cityCount; u++) {
+        for (Node* t = adjList[u]; t; t = t->next) {
+            sum += (t->cityIndex > u) ? t->cityIndex - u : u - t->cityIndex;
+            edges++;
+        }
+    }
+    return edges ? (double)sum / edges : 0.0;
+}
+
+/* BFS visiting order; with byDegree the unvisited neighbours of each
+   city are queued lowest-degree first (Cuthill-McKee) */
+static void bfsOrder(int order[], int byDegree) {
+    int visited[MAX] = {0};
+    int count = 0;
+
+    while (count < cityCount) {
+        /* seed each component: lowest index, or lowest degree for CM */
+        int seed = -1;
+        for (int i = 0; i < cityCount; i++) {
+            if (visited[i]) continue;
+            if (seed == -1 || (byDegree && degreeOf(i) < degreeOf(seed))) seed = i;
+        }
+
+        int front = count;
+        visited[seed] = 1;
+        order[count++] = seed;
+
+        while (front < count) {
+            int u = order[front++];
+            int first = count;
+            for (Node* t = adjList[u]; t; t = t->next) {
+                if (visited[t->cityIndex]) continue;
+                visited[t->cityIndex] = 1;
+                order[count++] = t->cityIndex;
+            }
+            if (!byDegree) continue;
+            for (int i = first + 1; i < count; i++) {
+                int v = order[i], j = i - 1;
+                while (j >= first && degreeOf(order[j]) > degreeOf(v)) {
+                    order[j + 1] = order[j];
+                    j--;
+                }
+                order[j + 1] = v;
+            }
+        }
+    }
+}
+
+/* renumber cities so that neighbours get nearby indices. The new order is
+   what the next snapshot writes, so it persists across runs. */
+void reorderGraph(int mode) {
+    int order[MAX], newIndex[MAX];
+    City oldCities[MAX];
+    Node* oldAdj[MAX];
+
+    if (cityCount == 0) return;
+
+    bfsOrder(order, mode == REORDER_RCM);
+    if (mode == REORDER_RCM) {
+        for (int i = 0, j = cityCount - 1; i < j; i++, j--) {
+            int tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+    }
+
+    for (int i = 0; i < cityCount; i++) {
+        newIndex[order[i]] = i;
+        oldCities[i] = cities[i];
+        oldAdj[i] = adjList[i];
+    }
+
+    for (int i = 0; i < cityCount; i++) {
+        cities[i] = oldCities[order[i]];
+
+        /* rebuild the list sorted by new neighbour index */
+        Node* sorted = NULL;
+        Node* cur = oldAdj[order[i]];
+        while (cur) {
+            Node* next = cur->next;
+            cur->cityIndex = newIndex[cur->cityIndex];
+
+            Node** pos = &sorted;
+            while (*pos && (*pos)->cityIndex < cur->cityIndex) pos = &(*pos)->next;
+            cur->next = *pos;
+            *pos = cur;
+
+            cur = next;
+        }
+        adjList[i] = sorted;
+    }
+    componentsInvalidate();
+    spatialInvalidate();
+    graphVersion++;
+}
+
 /* ------------------ persistence (simple text) ------------------ */
 
-void saveGraphToFile(const char* filename) {
+/* write a full snapshot and fsync it; returns 1 on success */
+int writeGraphSnapshot(const char* filename) {
     FILE* fp = fopen(filename, "w");
-    if (!fp) {
-        printf("Failed to open %s for writing.\n", filename);
-        return;
-    }
+    if (!fp) return 0;
 
     fprintf(fp, "%d\n", cityCount);
     for (int i = 0; i < cityCount; i++) {
@@ -268,78 +439,99 @@ void saveGraphToFile(const char* filename) {
         }
     }
 
-    fclose(fp);
-    printf("Graph saved to file '%s'.\n", filename);
+    syncToDisk(fp);
+    if (fclose(fp) != 0) return 0;
+
+    /* coordinates live in a side file so the snapshot format is unchanged */
+    char geoFile[272];
+    snprintf(geoFile, sizeof(geoFile), "%s.geo", filename);
+    fp = fopen(geoFile, "w");
+    if (!fp) return 0;
+    for (int i = 0; i < cityCount; i++) {
+        if (cities[i].located)
+            fprintf(fp, "%.6f %.6f %s\n", cities[i].x, cities[i].y, cities[i].name);
+    }
+    syncToDisk(fp);
+    return fclose(fp) == 0;
 }
 
+/* load the last snapshot, then replay the journal of later edits on top */
 void loadGraphFromFile(const char* filename) {
     FILE* fp = fopen(filename, "r");
-    if (!fp) {
-        /* no file is fine */
-        return;
-    }
-
-    /* clear current graph first */
-    for (int i = 0; i < cityCount; i++) {
-        Node* cur = adjList[i];
-        while (cur) {
-            Node* nx = cur->next;
-            free(cur);
-            cur = nx;
+    if (fp) {
+        /* clear current graph first */
+        for (int i = 0; i < cityCount; i++) {
+            Node* cur = adjList[i];
+            while (cur) {
+                Node* nx = cur->next;
+                free(cur);
+                cur = nx;
+            }
+            adjList[i] = NULL;
         }
-        adjList[i] = NULL;
-    }
-    cityCount = 0;
-
-    int n;
-    if (fscanf(fp, "%d\n", &n) != 1) { fclose(fp); return; }
-    char line[256];
-    for (int i = 0; i < n && i < MAX; i++) {
-        if (!fgets(line, sizeof(line), fp)) break;
-        line[strcspn(line, "\n")] = '\0';
-        strncpy(cities[i].name, line, NAME_LEN-1);
-        cities[i].name[NAME_LEN-1] = '\0';
-        adjList[i] = NULL;
-        cityCount++;
-    }
-
-    int a,b,d;
-    while (fscanf(fp, "%d %d %d", &a, &b, &d) == 3) {
-        if (a < 0 || a >= cityCount || b < 0 || b >= cityCount) continue;
-        Node* n1 = (Node*)malloc(sizeof(Node));
-        n1->cityIndex = b; n1->distance = d; n1->next = adjList[a]; adjList[a] = n1;
-        Node* n2 = (Node*)malloc(sizeof(Node));
-        n2->cityIndex = a; n2->distance = d; n2->next = adjList[b]; adjList[b] = n2;
+        cityCount = 0;
+
+        int n;
+        if (fscanf(fp, "%d\n", &n) == 1) {
+            char line[256];
+            for (int i = 0; i < n && i < MAX; i++) {
+                if (!fgets(line, sizeof(line), fp)) break;
+                line[strcspn(line, "\n")] = '\0';
+                strncpy(cities[i].name, line, NAME_LEN-1);
+                cities[i].name[NAME_LEN-1] = '\0';
+                cities[i].located = 0;
+                adjList[i] = NULL;
+                cityCount++;
+            }
+
+            int a,b,d;
+            while (fscanf(fp, "%d %d %d", &a, &b, &d) == 3) {
+                if (a < 0 || a >= cityCount || b < 0 || b >= cityCount) continue;
+                Node* n1 = (Node*)malloc(sizeof(Node));
+                n1->cityIndex = b; n1->distance = d; n1->next = adjList[a]; adjList[a] = n1;
+                Node* n2 = (Node*)malloc(sizeof(Node));
+                n2->cityIndex = a; n2->distance = d; n2->next = adjList[b]; adjList[b] = n2;
+            }
+        }
+        componentsInvalidate();
+        spatialInvalidate();
+        graphVersion++;
+        fclose(fp);
+
+        char geoFile[272], line[256];
+        double x, y;
+        int consumed;
+        snprintf(geoFile, sizeof(geoFile), "%s.geo", filename);
+        fp = fopen(geoFile, "r");
+        while (fp && fgets(line, sizeof(line), fp)) {
+            line[strcspn(line, "\n")] = '\0';
+            if (sscanf(line, "%lf %lf %n", &x, &y, &consumed) == 2)
+                locateCity(getCityIndex(line + consumed), x, y);
+        }
+        if (fp) fclose(fp);
     }
+    /* no snapshot is fine: the journal may still hold edits */
 
-    fclose(fp);
+    journalReplay(filename);
 }
 
 /* ------------------ route report saving ------------------ */
 
-/* reconstruct path using parent[] and save to file */
-void saveRouteReport(const char* method, int parent[], int endIdx, int totalDistance) {
-    if (endIdx < 0 || endIdx >= cityCount) return;
-    char pathNames[MAX][NAME_LEN];
-    int pathLen = 0;
-    for (int v = endIdx; v != -1; v = parent[v]) {
-        strncpy(pathNames[pathLen], cities[v].name, NAME_LEN-1);
-        pathNames[pathLen][NAME_LEN-1] = '\0';
-        pathLen++;
-    }
+/* save a route (path[] start first) to file */
+void saveRouteReport(const RouteGraph* g, const char* method, const RouteResult* r) {
+    if (r->stops <= 0) return;
 
-    /* reverse path to get start->...->end */
     FILE* fp = fopen("last_route.txt", "w");
     if (!fp) return;
 
     fprintf(fp, "Route Report\n");
     fprintf(fp, "Method: %s\n", method);
     fprintf(fp, "Path: ");
-    for (int i = pathLen - 1; i >= 0; i--) {
-        fprintf(fp, "%s", pathNames[i]);
-        if (i > 0) fprintf(fp, " -> ");
+    for (int i = 0; i < r->stops; i++) {
+        fprintf(fp, "%s", g->names[r->path[i]]);
+        if (i < r->stops - 1) fprintf(fp, " -> ");
     }
-    fprintf(fp, "\nTotal Distance: %d km\n", totalDistance);
+    fprintf(fp, "\nTotal Distance: %d km\n", r->total);
     fclose(fp);
     printf("Route saved to 'last_route.txt'.\n");
 }
@@ -354,7 +546,14 @@ void suggestCity(const char* partial) {
             found = 1;
         }
     }
-    if (!found) printf("No matches found.");
+    if (!found) {
+        /* no prefix match: offer the closest names instead */
+        int match[FUZZY_MAX_RESULTS], dist[FUZZY_MAX_RESULTS];
+        int n = fuzzyMatches(partial, defaultMaxEdits(partial), match, dist, FUZZY_MAX_RESULTS);
+        if (n == 0) printf("No matches found.");
+        else printf("Did you mean: ");
+        for (int i = 0; i < n; i++) printf("%s ", cities[match[i]].name);
+    }
     printf("\n");
 }
 
@@ -9,6 +9,8 @@
 // City structure
 typedef struct City {
     char name[NAME_LEN];
+    double x, y;        /* map coordinates, valid when located */
+    int located;
 } City;
 
 // Adjacency list node (edge)
@@ -22,6 +24,7 @@ typedef struct Node {
 extern City cities[MAX];
 extern int cityCount;
 extern Node* adjList[MAX];
+extern unsigned long graphVersion;  /* changes whenever cities/roads change */
 
 /* graph functions */
 int getCityIndex(const char* name);
@@ -29,6 +32,16 @@ void addCity(const char* name);
 void addRoad(const char* city1, const char* city2, int distance);
 void displayGraph();
 
+/* silent index-level mutators: no output, not journaled (used by replay) */
+int insertCity(const char* name);
+int insertRoad(int a, int b, int distance);
+int removeRoad(int a, int b);
+void removeCity(int idx);
+void locateCity(int idx, double x, double y);
+
+/* coordinates */
+void setCityLocation(const char* name, double x, double y);
+
 /* deletion */
 void deleteRoad(const char* city1, const char* city2);
 void deleteCity(const char* name);
@@ -38,12 +51,20 @@ int getEdgeDistance(int u, int v);
 void displayAdjacencyMatrix(void);
 void getGraphStats(int* totalCities, int* totalRoads, double* avgDistance, int* mostConnectedIndex);
 
+/* locality reordering */
+#define REORDER_BFS 1
+#define REORDER_RCM 2   /* reverse Cuthill-McKee */
+void reorderGraph(int mode);
+double averageIndexGap(void);
+
 /* persistence */
-void saveGraphToFile(const char* filename);
+int writeGraphSnapshot(const char* filename);
 void loadGraphFromFile(const char* filename);
 
-/* route report */
-void saveRouteReport(const char* method, int parent[], int endIdx, int totalDistance);
+/* route report (names come from the handle the route was computed on) */
+struct RouteGraph;
+struct RouteResult;
+void saveRouteReport(const struct RouteGraph* g, const char* method, const struct RouteResult* r);
 
 //helper
 
@@ -0,0 +1,263 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L   // fileno(), fsync(), truncate() under strict -std=c99
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h> // MoveFileExA()
+#include <io.h>      // _commit(), _chsize()
+#include <fcntl.h>
+#else
+#include <fcntl.h>   // open()
+#include <unistd.h>  // fsync(), truncate()
+#endif
+
+#include "graph.h"
+#include "ui.h"
+#include "journal.h"
+
+static FILE* journalFp = NULL;
+static char snapshotPath[256] = "";
+static char journalPath[272] = "";
+static int recordCount = 0;     /* records since the last snapshot */
+static int unsynced = 0;        /* records written but not yet fsync'ed */
+
+/* ------------------ helpers ------------------ */
+
+static void journalPathFor(const char* snapshotFile, char* out, size_t size) {
+    snprintf(out, size, "%s.journal", snapshotFile);
+}
+
+void syncToDisk(FILE* fp) {
+    fflush(fp);
+#ifdef _WIN32
+    _commit(_fileno(fp));
+#else
+    fsync(fileno(fp));
+#endif
+}
+
+/* cut a torn tail off the journal so the next append starts a fresh line */
+static int truncateFile(const char* path, long length) {
+#ifdef _WIN32
+    int fd = _open(path, _O_WRONLY | _O_BINARY);
+    if (fd == -1) return 0;
+    int ok = _chsize(fd, length) == 0;
+    _close(fd);
+    return ok;
+#else
+    return truncate(path, (off_t)length) == 0;
+#endif
+}
+
+/* split a record in place on tabs; returns the number of fields */
+static int splitFields(char* line, char* field[], int maxFields) {
+    int n = 0;
+    field[n++] = line;
+    for (char* p = line; *p && n < maxFields; p++) {
+        if (*p == '\t') {
+            *p = '\0';
+            field[n++] = p + 1;
+        }
+    }
+    return n;
+}
+
+/* ------------------ writing ------------------ */
+
+void journalOpen(const char* snapshotFile) {
+    strncpy(snapshotPath, snapshotFile, sizeof(snapshotPath) - 1);
+    snapshotPath[sizeof(snapshotPath) - 1] = '\0';
+    journalPathFor(snapshotPath, journalPath, sizeof(journalPath));
+
+    journalFp = fopen(journalPath, "a");
+    if (!journalFp) printError("Could not open journal; edits will not be saved.");
+}
+
+/* append one edit. Each record is handed to the OS immediately; fsync is
+   batched every JOURNAL_SYNC_BATCH records. */
+void journalRecord(char op, const char* city1, const char* city2, int distance) {
+    if (!journalFp) return;
+
+    switch (op) {
+        case JOURNAL_ADD_ROAD:
+            fprintf(journalFp, "%c\t%s\t%s\t%d\n", op, city1, city2, distance);
+            break;
+        case JOURNAL_DELETE_ROAD:
+            fprintf(journalFp, "%c\t%s\t%s\n", op, city1, city2);
+            break;
+        default:
+            fprintf(journalFp, "%c\t%s\n", op, city1);
+    }
+    fflush(journalFp);
+
+    recordCount++;
+    if (++unsynced >= JOURNAL_SYNC_BATCH) journalFlush();
+}
+
+void journalLocation(const char* city, double x, double y) {
+    if (!journalFp) return;
+
+    fprintf(journalFp, "%c\t%s\t%.6f\t%.6f\n", JOURNAL_LOCATE_CITY, city, x, y);
+    fflush(journalFp);
+
+    recordCount++;
+    if (++unsynced >= JOURNAL_SYNC_BATCH) journalFlush();
+}
+
+void journalFlush(void) {
+    if (!journalFp || unsynced == 0) return;
+    syncToDisk(journalFp);
+    unsynced = 0;
+}
+
+/* ------------------ replay ------------------ */
+
+/* apply the journal next to snapshotFile to the loaded graph. A torn
+   trailing record is dropped from the file as well, so journalOpen()
+   appends after the last complete record. Returns the number of records
+   applied. */
+int journalReplay(const char* snapshotFile) {
+    char path[272];
+    journalPathFor(snapshotFile, path, sizeof(path));
+
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return 0;
+
+    char line[256];
+    char* field[4];
+    int applied = 0;
+    long complete = 0;      /* offset just past the last complete record */
+    int torn = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (!strchr(line, '\n')) {
+            /* a record without its newline was torn by a crash: stop there */
+            if (feof(fp)) {
+                torn = 1;
+                break;
+            }
+            /* over-long line: not a record we write, skip the rest of it */
+            int c;
+            while ((c = fgetc(fp)) != EOF && c != '\n');
+            if (c == EOF) {
+                torn = 1;
+                break;
+            }
+            complete = ftell(fp);
+            continue;
+        }
+        complete = ftell(fp);
+        line[strcspn(line, "\r\n")] = '\0';
+
+        int n = splitFields(line, field, 4);
+        if (n < 2) continue;
+
+        switch (field[0][0]) {
+            case JOURNAL_ADD_CITY:
+                insertCity(field[1]);
+                break;
+            case JOURNAL_ADD_ROAD:
+                if (n < 4) continue;
+                insertRoad(getCityIndex(field[1]), getCityIndex(field[2]), atoi(field[3]));
+                break;
+            case JOURNAL_DELETE_ROAD: {
+                if (n < 3) continue;
+                int a = getCityIndex(field[1]);
+                int b = getCityIndex(field[2]);
+                if (a != -1 && b != -1) removeRoad(a, b);
+                break;
+            }
+            case JOURNAL_DELETE_CITY: {
+                int idx = getCityIndex(field[1]);
+                if (idx != -1) removeCity(idx);
+                break;
+            }
+            case JOURNAL_LOCATE_CITY:
+                if (n < 4) continue;
+                locateCity(getCityIndex(field[1]), atof(field[2]), atof(field[3]));
+                break;
+            default:
+                continue;
+        }
+        applied++;
+    }
+
+    fclose(fp);
+    if (torn) truncateFile(path, complete);
+    recordCount = applied;
+    return applied;
+}
+
+/* ------------------ compaction ------------------ */
+
+#ifndef _WIN32
+/* make a rename in path's directory durable */
+static int syncParentDir(const char* path) {
+    char dir[272];
+    const char* slash = strrchr(path, '/');
+    if (slash) snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path) + 1, path);
+    else snprintf(dir, sizeof(dir), ".");
+
+    int fd = open(dir, O_RDONLY);
+    if (fd == -1) return 0;
+    int ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+#endif
+
+/* atomically replace `to` with `from` and wait until the swap is on disk */
+static int replaceFile(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (rename(from, to) != 0) return 0;
+    return syncParentDir(to);
+#endif
+}
+
+/* move the coordinates side file written with a temp snapshot */
+static int renameGeoFile(const char* tmpSnapshot) {
+    char from[288], to[272];
+    snprintf(from, sizeof(from), "%s.geo", tmpSnapshot);
+    snprintf(to, sizeof(to), "%s.geo", snapshotPath);
+    return replaceFile(from, to);
+}
+
+/* fold the journal into a fresh snapshot: write and fsync it beside the
+   old one, swap it in, and only once the swap is durable start an empty
+   journal. If we crash before the journal is truncated, replaying it
+   again over the new snapshot re-applies edits that are already there,
+   which is harmless. */
+int journalCompact(void) {
+    char tmp[272];
+    if (snapshotPath[0] == '\0') return 0;
+
+    journalFlush();
+    snprintf(tmp, sizeof(tmp), "%s.tmp", snapshotPath);
+    if (!writeGraphSnapshot(tmp)) return 0;
+    if (!renameGeoFile(tmp)) return 0;
+    if (!replaceFile(tmp, snapshotPath)) return 0;
+
+    if (journalFp) fclose(journalFp);
+    journalFp = fopen(journalPath, "w");
+    if (journalFp) syncToDisk(journalFp);
+    recordCount = 0;
+    unsynced = 0;
+    return 1;
+}
+
+/* called between menu actions so compaction never interrupts an edit */
+void journalMaybeCompact(void) {
+    if (recordCount >= JOURNAL_COMPACT_LIMIT) journalCompact();
+}
+
+void journalClose(void) {
+    journalFlush();
+    journalMaybeCompact();
+    if (journalFp) fclose(journalFp);
+    journalFp = NULL;
+}
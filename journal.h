@@ -0,0 +1,29 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdio.h>
+
+/* Append-only write-ahead journal of map edits.
+   Lives next to the snapshot as "<snapshot>.journal"; one tab-separated
+   line per edit, replayed over the snapshot at load time. */
+
+#define JOURNAL_ADD_CITY    'C'
+#define JOURNAL_ADD_ROAD    'R'
+#define JOURNAL_DELETE_ROAD 'D'
+#define JOURNAL_DELETE_CITY 'X'
+#define JOURNAL_LOCATE_CITY 'L'
+
+#define JOURNAL_SYNC_BATCH    8     /* records per fsync */
+#define JOURNAL_COMPACT_LIMIT 256   /* records before folding into the snapshot */
+
+void syncToDisk(FILE* fp);
+void journalOpen(const char* snapshotFile);
+void journalRecord(char op, const char* city1, const char* city2, int distance);
+void journalLocation(const char* city, double x, double y);
+void journalFlush(void);
+int journalReplay(const char* snapshotFile);
+void journalMaybeCompact(void);
+int journalCompact(void);
+void journalClose(void);
+
+#endif
@@ -5,6 +5,13 @@
 #include "ui.h"
 #include "graph.h"
 #include "algorithms.h"
+#include "partition.h"
+#include "compact.h"
+#include "journal.h"
+#include "components.h"
+#include "sssp.h"
+#include "spatial.h"
+#include "tour.h"
 
 #define SAVE_FILE "city_data.txt"
 
@@ -27,20 +34,25 @@ int main() {
     int choice;
     char city1[NAME_LEN], city2[NAME_LEN];
     int dist;
+    WeightProfile trafficProfile;
 
     clearScreen();
     printHeader();
 
     /* -----------------------------------------------------
-       Load previous graph data from file (if it exists)
+       Load previous graph data from file (if it exists),
+       replaying the journal of unsaved edits on top
     ----------------------------------------------------- */
     loadGraphFromFile(SAVE_FILE);
+    journalOpen(SAVE_FILE);
     printSuccess("Previous data loaded successfully (if file existed).");
+    initWeightProfile(&trafficProfile, "traffic");
 
     /* -----------------------------------------------------
        MAIN MENU LOOP
     ----------------------------------------------------- */
     while (1) {
+        journalMaybeCompact();
         printMainMenu();
 
 
@@ -108,6 +120,16 @@ int main() {
                 if (mostIdx >= 0)
                     printf("Most Connected City: %s\n", cities[mostIdx].name);
 
+                int sizes[MAX];
+                int components = getComponentSizes(sizes);
+                printf("Connected Regions  : %d (sizes:", components);
+                for (int i = 0; i < components; i++)
+                    printf(" %d%s", sizes[i], i < components - 1 ? "," : "");
+                printf(")\n");
+
+                printf("Adjacency Memory   : %d bytes (lists), %d bytes (compact)\n",
+                       adjacencyListBytes(), compactGraphBytes(&currentRouteGraph()->adj));
+
                 printf("===================================\n");
                 break;
             }
@@ -161,8 +183,161 @@ int main() {
                 suggestCity(city1);
                 break;
 
-            case 11: // Save and Exit
-                saveGraphToFile(SAVE_FILE);
+            case 11: // Route over the customized overlay
+                printf("Start city: ");
+                readLine(city1, sizeof(city1));
+                suggestCity(city1);
+
+                printf("Destination city: ");
+                readLine(city2, sizeof(city2));
+                suggestCity(city2);
+
+                overlayShortestPath(&trafficProfile, city1, city2);
+                break;
+
+            case 12: // Re-weight a road in the traffic profile
+                printf("Enter first city: ");
+                readLine(city1, sizeof(city1));
+
+                printf("Enter second city: ");
+                readLine(city2, sizeof(city2));
+
+                printf("Enter travel weight (-1 closes the road): ");
+                if (scanf("%d", &dist) != 1) {
+                    printError("Invalid weight value!");
+                    while (getchar() != '\n');
+                    break;
+                }
+                getchar(); // clear newline
+
+                if (setProfileRoadWeight(&trafficProfile, city1, city2, dist)) {
+                    customizeOverlay(&trafficProfile);
+                    printSuccess("Traffic profile updated!");
+                }
+                break;
+
+            case 13: { // Renumber cities so neighbours sit close in memory
+                int mode;
+                printf("1. BFS order\n2. Reverse Cuthill-McKee\nChoose ordering: ");
+                if (scanf("%d", &mode) != 1 || (mode != REORDER_BFS && mode != REORDER_RCM)) {
+                    printError("Invalid ordering!");
+                    while (getchar() != '\n');
+                    break;
+                }
+                getchar(); // clear newline
+
+                double before = averageIndexGap();
+                reorderGraph(mode);
+                printf("Average index gap per road: %.2f -> %.2f\n", before, averageIndexGap());
+
+                /* the journal is name-based, so persist the new ids via a snapshot */
+                if (journalCompact()) printSuccess("Cities reordered and saved.");
+                else printError("Cities reordered, but the snapshot could not be written.");
+                break;
+            }
+
+            case 14: { // Isochrone from one or more source cities
+                char sourceList[MAX * NAME_LEN];
+                printf("Source cities (comma-separated): ");
+                readLine(sourceList, sizeof(sourceList));
+
+                printf("Distance budget (km): ");
+                if (scanf("%d", &dist) != 1) {
+                    printError("Invalid distance value!");
+                    while (getchar() != '\n');
+                    break;
+                }
+                getchar(); // clear newline
+
+                citiesWithinRange(sourceList, dist);
+                break;
+            }
+
+            case 15: // One-to-all distances with delta-stepping
+                printf("Start city: ");
+                readLine(city1, sizeof(city1));
+                suggestCity(city1);
+
+                printf("Bucket width delta in km (0 = auto): ");
+                if (scanf("%d", &dist) != 1) {
+                    printError("Invalid delta value!");
+                    while (getchar() != '\n');
+                    break;
+                }
+                getchar(); // clear newline
+
+                showDistanceField(city1, dist);
+                break;
+
+            case 16: { // Place a city on the map
+                double x, y;
+                printf("Enter city name: ");
+                readLine(city1, sizeof(city1));
+
+                printf("Enter coordinates (x y): ");
+                if (scanf("%lf %lf", &x, &y) != 2) {
+                    printError("Invalid coordinates!");
+                    while (getchar() != '\n');
+                    break;
+                }
+                getchar(); // clear newline
+
+                setCityLocation(city1, x, y);
+                break;
+            }
+
+            case 17: { // Snap a point to its nearest cities
+                double x, y;
+                int k, found, nearest[MAX];
+                printf("Enter point and count (x y k): ");
+                if (scanf("%lf %lf %d", &x, &y, &k) != 3 || k < 1) {
+                    printError("Invalid input! Count must be at least 1.");
+                    while (getchar() != '\n');
+                    break;
+                }
+                getchar(); // clear newline
+
+                found = nearestCities(x, y, k, nearest);
+                if (found == 0) printf("No cities have a location yet.\n");
+                for (int i = 0; i < found; i++) {
+                    City* c = &cities[nearest[i]];
+                    printf("%d. %-*s (%.4f, %.4f)\n", i + 1, NAME_LEN, c->name, c->x, c->y);
+                }
+                break;
+            }
+
+            case 18: { // Bounding-box lookup
+                double x0, y0, x1, y1;
+                int found, inside[MAX];
+                printf("Enter corners (x0 y0 x1 y1): ");
+                if (scanf("%lf %lf %lf %lf", &x0, &y0, &x1, &y1) != 4) {
+                    printError("Invalid input!");
+                    while (getchar() != '\n');
+                    break;
+                }
+                getchar(); // clear newline
+
+                found = citiesInRect(x0, y0, x1, y1, inside);
+                printf("Cities in area: %d\n", found);
+                for (int i = 0; i < found; i++) printf("  %s\n", cities[inside[i]].name);
+                break;
+            }
+
+            case 19: { // Optimize the visiting order of a stop list
+                char stopList[MAX * NAME_LEN];
+                char answer[8];
+                printf("Stops (comma-separated, first is the depot): ");
+                readLine(stopList, sizeof(stopList));
+
+                printf("Return to the depot? (y/n): ");
+                readLine(answer, sizeof(answer));
+
+                multiStopTour(stopList, answer[0] == 'y' || answer[0] == 'Y');
+                break;
+            }
+
+            case 0: // Save and Exit (edits are already journaled)
+                journalClose();
                 printSuccess("Data saved successfully. Goodbye!");
                 return 0;
 
@@ -0,0 +1,345 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "graph.h"
+#include "ui.h"
+#include "algorithms.h"
+#include "partition.h"
+#include "components.h"
+#include "fuzzy.h"
+
+#define INF INT_MAX
+
+/* level 0 is the base graph: every city is its own cell */
+static const int cellSize[PART_LEVELS + 1] = { 1, CELL_SIZE_L1, CELL_SIZE_L2 };
+
+/* ---------- metric-independent partition ---------- */
+static int cellOf[PART_LEVELS + 1][MAX];
+static int cellCount[PART_LEVELS + 1];
+static int boundary[PART_LEVELS + 1][MAX][MAX];   /* boundary cities of each cell */
+static int boundaryCount[PART_LEVELS + 1][MAX];
+
+/* ---------- customization (depends on the weight profile) ---------- */
+static int edgeWeight[MAX][MAX];                  /* INF = no usable road */
+static int clique[PART_LEVELS + 1][MAX][MAX];     /* cell-internal shortcut u->v */
+
+static unsigned long partitionVersion = (unsigned long)-1;
+static unsigned long customizedVersion = (unsigned long)-1;
+static const WeightProfile* customizedProfile = NULL;
+static int customizedRevision = -1;
+
+/* ------------------ weight profiles ------------------ */
+
+void initWeightProfile(WeightProfile* p, const char* name) {
+    strncpy(p->name, name, NAME_LEN);
+    p->name[NAME_LEN-1] = '\0';
+    p->revision = 0;
+    p->overrideCount = 0;
+}
+
+/* override the weight of one road (-1 closes it). Returns 1 on success. */
+int setProfileRoadWeight(WeightProfile* p, const char* city1, const char* city2, int weight) {
+    int a = getCityIndex(city1);
+    int b = getCityIndex(city2);
+    if (a == -1 || b == -1) {
+        printf("Error: One or both cities not found.\n");
+        return 0;
+    }
+    if (getEdgeDistance(a, b) == 0) {
+        printf("No direct road between '%s' and '%s'.\n", city1, city2);
+        return 0;
+    }
+
+    for (int i = 0; i < p->overrideCount; i++) {
+        RoadOverride* o = &p->overrides[i];
+        if ((strcmp(o->from, city1) == 0 && strcmp(o->to, city2) == 0) ||
+            (strcmp(o->from, city2) == 0 && strcmp(o->to, city1) == 0)) {
+            o->weight = weight;
+            p->revision++;
+            return 1;
+        }
+    }
+    if (p->overrideCount >= MAX_OVERRIDES) {
+        printError("Cannot add more road overrides. Limit reached.");
+        return 0;
+    }
+
+    RoadOverride* o = &p->overrides[p->overrideCount++];
+    strncpy(o->from, city1, NAME_LEN);
+    o->from[NAME_LEN-1] = '\0';
+    strncpy(o->to, city2, NAME_LEN);
+    o->to[NAME_LEN-1] = '\0';
+    o->weight = weight;
+    p->revision++;
+    return 1;
+}
+
+/* ------------------ partition (topology only) ------------------ */
+
+/* group the cells of level l-1 into level-l cells by BFS region growing */
+static void growLevel(int l) {
+    int units = cellCount[l - 1];
+    int unitSize[MAX] = {0}, group[MAX], queue[MAX];
+
+    for (int v = 0; v < cityCount; v++) unitSize[cellOf[l - 1][v]]++;
+    for (int c = 0; c < units; c++) group[c] = -1;
+
+    int groups = 0;
+    for (int seed = 0; seed < units; seed++) {
+        if (group[seed] != -1) continue;
+
+        int size = unitSize[seed], front = 0, rear = 0;
+        group[seed] = groups;
+        queue[rear++] = seed;
+
+        while (front < rear) {
+            int c = queue[front++];
+            for (int v = 0; v < cityCount; v++) {
+                if (cellOf[l - 1][v] != c) continue;
+                for (Node* t = adjList[v]; t; t = t->next) {
+                    int d = cellOf[l - 1][t->cityIndex];
+                    if (group[d] != -1 || size + unitSize[d] > cellSize[l]) continue;
+                    group[d] = groups;
+                    size += unitSize[d];
+                    queue[rear++] = d;
+                }
+            }
+        }
+        groups++;
+    }
+
+    for (int v = 0; v < cityCount; v++) cellOf[l][v] = group[cellOf[l - 1][v]];
+    cellCount[l] = groups;
+}
+
+void buildPartition(void) {
+    for (int v = 0; v < cityCount; v++) cellOf[0][v] = v;
+    cellCount[0] = cityCount;
+
+    for (int l = 1; l <= PART_LEVELS; l++) {
+        growLevel(l);
+
+        /* boundary cities have a road leaving their level-l cell */
+        for (int c = 0; c < cellCount[l]; c++) boundaryCount[l][c] = 0;
+        for (int v = 0; v < cityCount; v++) {
+            for (Node* t = adjList[v]; t; t = t->next) {
+                if (cellOf[l][t->cityIndex] != cellOf[l][v]) {
+                    int c = cellOf[l][v];
+                    boundary[l][c][boundaryCount[l][c]++] = v;
+                    break;
+                }
+            }
+        }
+    }
+
+    partitionVersion = graphVersion;
+    customizedVersion = (unsigned long)-1;
+}
+
+/* ------------------ customization (per weight profile) ------------------ */
+
+static void resolveWeights(const WeightProfile* p) {
+    for (int u = 0; u < cityCount; u++)
+        for (int v = 0; v < cityCount; v++) edgeWeight[u][v] = INF;
+
+    for (int u = 0; u < cityCount; u++)
+        for (Node* t = adjList[u]; t; t = t->next) edgeWeight[u][t->cityIndex] = t->distance;
+
+    for (int i = 0; i < p->overrideCount; i++) {
+        int a = getCityIndex(p->overrides[i].from);
+        int b = getCityIndex(p->overrides[i].to);
+        if (a == -1 || b == -1 || edgeWeight[a][b] == INF) continue;
+        int w = p->overrides[i].weight < 0 ? INF : p->overrides[i].weight;
+        edgeWeight[a][b] = w;
+        edgeWeight[b][a] = w;
+    }
+}
+
+/* Dijkstra restricted to the level-l cell of src. Uses the shortcuts of
+   level `below` (below == 0 means plain roads only). */
+static void cellSearch(int l, int below, int src, int dist[], int parent[]) {
+    int c = cellOf[l][src];
+    int done[MAX] = {0};
+
+    for (int v = 0; v < cityCount; v++) {
+        dist[v] = INF;
+        parent[v] = -1;
+    }
+    dist[src] = 0;
+
+    while (1) {
+        int u = -1;
+        for (int v = 0; v < cityCount; v++) {
+            if (!done[v] && dist[v] != INF && cellOf[l][v] == c && (u == -1 || dist[v] < dist[u]))
+                u = v;
+        }
+        if (u == -1) break;
+        done[u] = 1;
+
+        if (below > 0) {
+            int cu = cellOf[below][u];
+            for (int i = 0; i < boundaryCount[below][cu]; i++) {
+                int w = boundary[below][cu][i];
+                int d = clique[below][u][w];
+                if (d != INF && dist[u] + d < dist[w]) {
+                    dist[w] = dist[u] + d;
+                    parent[w] = u;
+                }
+            }
+        }
+
+        for (Node* t = adjList[u]; t; t = t->next) {
+            int v = t->cityIndex;
+            int d = edgeWeight[u][v];
+            if (cellOf[l][v] != c || d == INF) continue;
+            if (below > 0 && cellOf[below][v] == cellOf[below][u]) continue;   /* covered by shortcuts */
+            if (dist[u] + d < dist[v]) {
+                dist[v] = dist[u] + d;
+                parent[v] = u;
+            }
+        }
+    }
+}
+
+void customizeOverlay(const WeightProfile* p) {
+    if (partitionVersion != graphVersion) buildPartition();
+    resolveWeights(p);
+
+    /* bottom-up: level l cliques are built from level l-1 cliques */
+    for (int l = 1; l <= PART_LEVELS; l++) {
+        /* cells are independent of each other */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < cellCount[l]; c++) {
+            int dist[MAX], parent[MAX];
+            for (int i = 0; i < boundaryCount[l][c]; i++) {
+                int b = boundary[l][c][i];
+                cellSearch(l, l - 1, b, dist, parent);
+                for (int j = 0; j < boundaryCount[l][c]; j++) {
+                    int w = boundary[l][c][j];
+                    clique[l][b][w] = dist[w];
+                }
+            }
+        }
+    }
+
+    customizedProfile = p;
+    customizedRevision = p->revision;
+    customizedVersion = graphVersion;
+}
+
+/* ------------------ multilevel query ------------------ */
+
+/* highest level at which u lies outside both the source and target cells */
+static int queryLevel(int u, int s, int t) {
+    for (int l = PART_LEVELS; l >= 1; l--) {
+        if (cellOf[l][u] != cellOf[l][s] && cellOf[l][u] != cellOf[l][t]) return l;
+    }
+    return 0;
+}
+
+/* Fills out with the plain-road route (legs in km) and returns the
+   travel cost under profile p, or -1 if t is unreachable. */
+int overlayRoute(const WeightProfile* p, int s, int t, RouteResult* out) {
+    out->stops = 0;
+    out->total = 0;
+    if (!sameComponent(s, t)) return -1;
+
+    if (partitionVersion != graphVersion || customizedVersion != graphVersion ||
+        customizedProfile != p || customizedRevision != p->revision)
+        customizeOverlay(p);
+
+    int dist[MAX], parent[MAX], via[MAX], done[MAX] = {0};
+    for (int v = 0; v < cityCount; v++) {
+        dist[v] = INF;
+        parent[v] = -1;
+        via[v] = 0;
+    }
+    dist[s] = 0;
+
+    while (1) {
+        int u = -1;
+        for (int v = 0; v < cityCount; v++) {
+            if (!done[v] && dist[v] != INF && (u == -1 || dist[v] < dist[u])) u = v;
+        }
+        if (u == -1 || u == t) break;
+        done[u] = 1;
+
+        int l = queryLevel(u, s, t);
+        if (l > 0) {
+            /* jump across u's cell through the overlay */
+            int cu = cellOf[l][u];
+            for (int i = 0; i < boundaryCount[l][cu]; i++) {
+                int w = boundary[l][cu][i];
+                int d = clique[l][u][w];
+                if (w != u && d != INF && dist[u] + d < dist[w]) {
+                    dist[w] = dist[u] + d;
+                    parent[w] = u;
+                    via[w] = l;
+                }
+            }
+        }
+
+        for (Node* e = adjList[u]; e; e = e->next) {
+            int v = e->cityIndex;
+            int d = edgeWeight[u][v];
+            if (d == INF) continue;
+            if (l > 0 && cellOf[l][v] == cellOf[l][u]) continue;
+            if (dist[u] + d < dist[v]) {
+                dist[v] = dist[u] + d;
+                parent[v] = u;
+                via[v] = 0;
+            }
+        }
+    }
+
+    if (dist[t] == INF) return -1;
+
+    /* unpack shortcuts into plain roads (collected end first) */
+    int rev[MAX], n = 0;
+    for (int v = t; v != s; v = parent[v]) {
+        if (via[v] == 0) {
+            rev[n++] = v;
+            continue;
+        }
+        int cdist[MAX], cparent[MAX];
+        cellSearch(via[v], 0, parent[v], cdist, cparent);
+        for (int x = v; x != parent[v]; x = cparent[x]) rev[n++] = x;
+    }
+    rev[n++] = s;
+
+    out->stops = n;
+    for (int i = 0; i < n; i++) {
+        out->path[i] = rev[n - 1 - i];
+        if (i > 0) {
+            out->legs[i - 1] = getEdgeDistance(out->path[i - 1], out->path[i]);
+            out->total += out->legs[i - 1];
+        }
+    }
+    return dist[t];
+}
+
+void overlayShortestPath(const WeightProfile* p, const char* start, const char* end) {
+    int s = resolveCityName(start);
+    int e = resolveCityName(end);
+    if (s == -1 || e == -1) {
+        printf("Invalid city name.\n");
+        return;
+    }
+    start = cities[s].name;
+    end = cities[e].name;
+
+    RouteResult r;
+    int cost = overlayRoute(p, s, e, &r);
+    if (cost < 0) {
+        printf("No route from %s to %s under profile '%s'.\n", start, end, p->name);
+        return;
+    }
+
+    printf("\nShortest Path (Overlay - profile '%s'):\n", p->name);
+    displayRoute(currentRouteGraph(), &r);
+    printf("Travel Cost (profile '%s'): %d\n", p->name, cost);
+    showRouteSummary(&r);
+}
@@ -0,0 +1,44 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "graph.h"
+#include "route.h"
+
+/* Multilevel partition + overlay (customizable route planning).
+   The partition depends only on the road topology; the overlay
+   (boundary cliques) is recomputed cheaply for each weight profile. */
+
+#define PART_LEVELS 2          /* overlay levels above the base graph */
+#define MAX_OVERRIDES 64
+
+/* per-level cell sizes (level 1 = finest) */
+#define CELL_SIZE_L1 8
+#define CELL_SIZE_L2 32
+
+/* a weight profile: base road distances with per-road overrides */
+typedef struct RoadOverride {
+    char from[NAME_LEN];
+    char to[NAME_LEN];
+    int weight;                /* -1 = road closed */
+} RoadOverride;
+
+typedef struct WeightProfile {
+    char name[NAME_LEN];
+    int revision;              /* bumped on every change */
+    int overrideCount;
+    RoadOverride overrides[MAX_OVERRIDES];
+} WeightProfile;
+
+/* profiles */
+void initWeightProfile(WeightProfile* p, const char* name);
+int setProfileRoadWeight(WeightProfile* p, const char* city1, const char* city2, int weight);
+
+/* preprocessing */
+void buildPartition(void);
+void customizeOverlay(const WeightProfile* p);
+
+/* queries */
+int overlayRoute(const WeightProfile* p, int s, int t, RouteResult* out);
+void overlayShortestPath(const WeightProfile* p, const char* start, const char* end);
+
+#endif
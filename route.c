@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "graph.h"
+#include "compact.h"
+#include "route.h"
+
+#define INF INT_MAX
+
+/* ------------------ graph handles ------------------ */
+
+/* snapshot the live map into g (not thread-safe; queries on g are) */
+void routeGraphBuild(RouteGraph* g) {
+    g->cityCount = cityCount;
+    for (int i = 0; i < cityCount; i++) {
+        memcpy(g->names[i], cities[i].name, NAME_LEN);
+    }
+    buildCompactGraph(&g->adj);
+}
+
+void routeGraphFree(RouteGraph* g) {
+    freeCompactGraph(&g->adj);
+    g->cityCount = 0;
+}
+
+/* handle for the menu, rebuilt only after the map changes */
+const RouteGraph* currentRouteGraph(void) {
+    static RouteGraph live;
+    static unsigned long liveVersion = (unsigned long)-1;
+
+    if (liveVersion != graphVersion) {
+        routeGraphFree(&live);
+        routeGraphBuild(&live);
+        liveVersion = graphVersion;
+    }
+    return &live;
+}
+
+/* exact name lookup; the index is only valid for g */
+int routeCityIndex(const RouteGraph* g, const char* name) {
+    for (int i = 0; i < g->cityCount; i++) {
+        if (strcmp(g->names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+/* ------------------ workspace ------------------ */
+
+void initWorkspace(SearchWorkspace* ws) {
+    memset(ws->stamp, 0, sizeof(ws->stamp));
+    ws->current = 0;
+    ws->heapSize = 0;
+}
+
+void workspaceBegin(SearchWorkspace* ws) {
+    if (ws->current == INT_MAX) initWorkspace(ws);
+    ws->current++;
+    ws->heapSize = 0;
+}
+
+int workspaceDist(const SearchWorkspace* ws, int v) {
+    return ws->stamp[v] == ws->current ? ws->dist[v] : INF;
+}
+
+int workspaceSettled(const SearchWorkspace* ws, int v) {
+    return ws->stamp[v] == ws->current && ws->heapPos[v] == -1;
+}
+
+static void heapSwap(SearchWorkspace* ws, int i, int j) {
+    int a = ws->heap[i], b = ws->heap[j];
+    ws->heap[i] = b;
+    ws->heap[j] = a;
+    ws->heapPos[b] = i;
+    ws->heapPos[a] = j;
+}
+
+static void heapUp(SearchWorkspace* ws, int i) {
+    while (i > 0) {
+        int p = (i - 1) / 2;
+        if (ws->dist[ws->heap[p]] <= ws->dist[ws->heap[i]]) break;
+        heapSwap(ws, i, p);
+        i = p;
+    }
+}
+
+int workspacePop(SearchWorkspace* ws) {
+    int top = ws->heap[0];
+    ws->heapPos[top] = -1;
+    ws->heapSize--;
+    if (ws->heapSize > 0) {
+        ws->heap[0] = ws->heap[ws->heapSize];
+        ws->heapPos[ws->heap[0]] = 0;
+        int i = 0;
+        while (1) {
+            int l = 2 * i + 1, r = l + 1, m = i;
+            if (l < ws->heapSize && ws->dist[ws->heap[l]] < ws->dist[ws->heap[m]]) m = l;
+            if (r < ws->heapSize && ws->dist[ws->heap[r]] < ws->dist[ws->heap[m]]) m = r;
+            if (m == i) break;
+            heapSwap(ws, i, m);
+            i = m;
+        }
+    }
+    return top;
+}
+
+/* set dist[v] = d (reached over a road of length leg) and push or decrease-key v */
+void workspacePush(SearchWorkspace* ws, int v, int d, int parent, int leg) {
+    if (ws->stamp[v] != ws->current) {
+        ws->stamp[v] = ws->current;
+        ws->heapPos[v] = -1;
+    }
+    ws->dist[v] = d;
+    ws->parent[v] = parent;
+    ws->leg[v] = leg;
+    if (ws->heapPos[v] == -1) {
+        ws->heapPos[v] = ws->heapSize;
+        ws->heap[ws->heapSize++] = v;
+    }
+    heapUp(ws, ws->heapPos[v]);
+}
+
+/* ------------------ one-to-all search ------------------ */
+
+/* shortest km from `from` to every city; read back with workspaceDist() */
+void routeSearchAll(const RouteGraph* g, int from, SearchWorkspace* ws) {
+    workspaceBegin(ws);
+    if (from < 0 || from >= g->cityCount) return;
+    workspacePush(ws, from, 0, -1, 0);
+
+    while (ws->heapSize > 0) {
+        int u = workspacePop(ws);
+        CompactCursor cur;
+        int v, w;
+        compactBegin(&cur, &g->adj, u);
+        while (compactNext(&cur, &v, &w)) {
+            int nd = ws->dist[u] + w;
+            if (workspaceSettled(ws, v) || nd >= workspaceDist(ws, v)) continue;
+            workspacePush(ws, v, nd, u, w);
+        }
+    }
+}
+
+/* ------------------ point-to-point query ------------------ */
+
+/* Fewest hops or shortest km from `from` to `to`. Fills out (start
+   first, with per-leg distances) and returns 1, or returns 0 if there is
+   no route. Touches nothing but g, ws and out; never allocates. */
+int routeQuery(const RouteGraph* g, int from, int to, int method,
+               SearchWorkspace* ws, RouteResult* out) {
+    out->stops = 0;
+    out->total = 0;
+    if (from < 0 || from >= g->cityCount || to < 0 || to >= g->cityCount) return 0;
+
+    workspaceBegin(ws);
+    workspacePush(ws, from, 0, -1, 0);
+
+    while (ws->heapSize > 0) {
+        int u = workspacePop(ws);
+        if (u == to) break;
+
+        CompactCursor cur;
+        int v, w;
+        compactBegin(&cur, &g->adj, u);
+        while (compactNext(&cur, &v, &w)) {
+            int nd = ws->dist[u] + (method == ROUTE_FEWEST_HOPS ? 1 : w);
+            if (workspaceSettled(ws, v) || nd >= workspaceDist(ws, v)) continue;
+            workspacePush(ws, v, nd, u, w);
+        }
+    }
+    if (!workspaceSettled(ws, to)) return 0;
+
+    for (int v = to; v != -1; v = ws->parent[v]) out->stops++;
+    int i = out->stops - 1;
+    for (int v = to; v != -1; v = ws->parent[v], i--) {
+        out->path[i] = v;
+        if (i > 0) {
+            out->legs[i - 1] = ws->leg[v];
+            out->total += ws->leg[v];
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,62 @@
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include "graph.h"
+#include "compact.h"
+
+/* Reentrant route engine.
+   A RouteGraph is an immutable snapshot of the map. Queries only read it
+   and keep their scratch state in a caller-owned SearchWorkspace, so any
+   number of threads may query the same or different graphs at once. */
+
+#define MAX_ROUTE_LEN (MAX * 4)   /* room for multi-stop tours that revisit cities */
+
+#define ROUTE_FEWEST_HOPS 1
+#define ROUTE_SHORTEST    2
+
+typedef struct RouteGraph {
+    int cityCount;
+    char names[MAX][NAME_LEN];
+    CompactGraph adj;
+} RouteGraph;
+
+typedef struct RouteResult {
+    int stops;                 /* cities on the route incl. start and end; 0 = no route */
+    int path[MAX_ROUTE_LEN];   /* start first */
+    int legs[MAX_ROUTE_LEN];   /* legs[i] = km from path[i] to path[i+1] */
+    int total;                 /* km */
+} RouteResult;
+
+/* reusable search state; entries are valid only where stamp == current,
+   so starting a new search costs O(1) instead of clearing every array */
+typedef struct SearchWorkspace {
+    int dist[MAX];
+    int parent[MAX];
+    int leg[MAX];        /* length of the road parent -> city */
+    int stamp[MAX];
+    int current;
+    int heap[MAX];       /* binary min-heap of cities keyed by dist */
+    int heapPos[MAX];
+    int heapSize;
+} SearchWorkspace;
+
+/* graph handles */
+void routeGraphBuild(RouteGraph* g);
+void routeGraphFree(RouteGraph* g);
+const RouteGraph* currentRouteGraph(void);
+int routeCityIndex(const RouteGraph* g, const char* name);
+
+/* queries */
+void initWorkspace(SearchWorkspace* ws);
+int routeQuery(const RouteGraph* g, int from, int to, int method,
+               SearchWorkspace* ws, RouteResult* out);
+void routeSearchAll(const RouteGraph* g, int from, SearchWorkspace* ws);
+
+/* workspace primitives shared with the other search engines */
+void workspaceBegin(SearchWorkspace* ws);
+int workspaceDist(const SearchWorkspace* ws, int v);
+int workspaceSettled(const SearchWorkspace* ws, int v);
+void workspacePush(SearchWorkspace* ws, int v, int d, int parent, int leg);
+int workspacePop(SearchWorkspace* ws);
+
+#endif
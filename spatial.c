@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <math.h>
+
+#include "graph.h"
+#include "spatial.h"
+
+static int dim = 0;                       /* cells per axis */
+static double minX, minY, cellW, cellH;
+static int cellHead[GRID_DIM * GRID_DIM]; /* first city in each cell */
+static int nextInCell[MAX];
+static int indexed[MAX];                  /* city is in some cell list */
+static int dirty = 1;
+
+/* ------------------ build ------------------ */
+
+static int cellCoord(double v, double lo, double size) {
+    int c = (int)((v - lo) / size);
+    if (c < 0) c = 0;
+    if (c >= dim) c = dim - 1;
+    return c;
+}
+
+static int inGrid(double x, double y) {
+    return dim > 0 && x >= minX && x <= minX + dim * cellW && y >= minY && y <= minY + dim * cellH;
+}
+
+static void insertIntoCell(int idx) {
+    int cell = cellCoord(cities[idx].y, minY, cellH) * dim + cellCoord(cities[idx].x, minX, cellW);
+    nextInCell[idx] = cellHead[cell];
+    cellHead[cell] = idx;
+    indexed[idx] = 1;
+}
+
+static void rebuild(void) {
+    double maxX = 0, maxY = 0;
+    int located = 0;
+
+    for (int i = 0; i < cityCount; i++) {
+        if (!cities[i].located) continue;
+        if (located == 0 || cities[i].x < minX) minX = cities[i].x;
+        if (located == 0 || cities[i].y < minY) minY = cities[i].y;
+        if (located == 0 || cities[i].x > maxX) maxX = cities[i].x;
+        if (located == 0 || cities[i].y > maxY) maxY = cities[i].y;
+        located++;
+    }
+
+    /* about two cities per cell */
+    dim = 1;
+    while (dim < GRID_DIM && dim * dim * 2 < located) dim++;
+    cellW = (maxX > minX) ? (maxX - minX) / dim : 1.0;
+    cellH = (maxY > minY) ? (maxY - minY) / dim : 1.0;
+
+    for (int c = 0; c < dim * dim; c++) cellHead[c] = -1;
+    for (int i = 0; i < MAX; i++) indexed[i] = 0;
+    for (int i = 0; i < cityCount; i++) {
+        if (cities[i].located) insertIntoCell(i);
+    }
+    dirty = 0;
+}
+
+/* ------------------ maintenance hooks ------------------ */
+
+void spatialOnCityLocated(int idx) {
+    if (dirty) return;
+    /* a moved city would leave a stale entry behind, and points outside
+       the grid would break the search bounds: rebuild in both cases */
+    if (indexed[idx] || !inGrid(cities[idx].x, cities[idx].y)) {
+        dirty = 1;
+        return;
+    }
+    insertIntoCell(idx);
+}
+
+void spatialInvalidate(void) {
+    dirty = 1;
+}
+
+/* ------------------ queries ------------------ */
+
+static double distTo(int idx, double x, double y) {
+    return hypot(cities[idx].x - x, cities[idx].y - y);
+}
+
+/* k nearest located cities to (x, y), closest first. Searches rings of
+   cells outward until no unvisited cell can hold anything closer. */
+int nearestCities(double x, double y, int k, int out[]) {
+    double best[MAX];
+    int found = 0;
+
+    if (dirty) rebuild();
+    if (k > MAX) k = MAX;
+    if (k <= 0) return 0;
+
+    int qx = cellCoord(x, minX, cellW);
+    int qy = cellCoord(y, minY, cellH);
+
+    for (int r = 0; r < dim; r++) {
+        for (int cy = qy - r; cy <= qy + r; cy++) {
+            for (int cx = qx - r; cx <= qx + r; cx++) {
+                if (cx < 0 || cy < 0 || cx >= dim || cy >= dim) continue;
+                if (cx != qx - r && cx != qx + r && cy != qy - r && cy != qy + r) continue;
+
+                for (int i = cellHead[cy * dim + cx]; i != -1; i = nextInCell[i]) {
+                    double d = distTo(i, x, y);
+                    if (found == k && d >= best[k - 1]) continue;
+
+                    int j = (found < k) ? found++ : k - 1;
+                    while (j > 0 && best[j - 1] > d) {
+                        best[j] = best[j - 1];
+                        out[j] = out[j - 1];
+                        j--;
+                    }
+                    best[j] = d;
+                    out[j] = i;
+                }
+            }
+        }
+
+        /* distance to the nearest cell not yet visited */
+        double bound = HUGE_VAL;
+        if (qx - r > 0) bound = fmin(bound, x - (minX + (qx - r) * cellW));
+        if (qx + r < dim - 1) bound = fmin(bound, minX + (qx + r + 1) * cellW - x);
+        if (qy - r > 0) bound = fmin(bound, y - (minY + (qy - r) * cellH));
+        if (qy + r < dim - 1) bound = fmin(bound, minY + (qy + r + 1) * cellH - y);
+
+        if (bound == HUGE_VAL || (found == k && best[k - 1] <= bound)) break;
+    }
+    return found;
+}
+
+/* located cities inside the rectangle; returns how many were written */
+int citiesInRect(double x0, double y0, double x1, double y1, int out[]) {
+    int found = 0;
+
+    if (dirty) rebuild();
+    if (x0 > x1) { double t = x0; x0 = x1; x1 = t; }
+    if (y0 > y1) { double t = y0; y0 = y1; y1 = t; }
+
+    int cx0 = cellCoord(x0, minX, cellW), cx1 = cellCoord(x1, minX, cellW);
+    int cy0 = cellCoord(y0, minY, cellH), cy1 = cellCoord(y1, minY, cellH);
+
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            for (int i = cellHead[cy * dim + cx]; i != -1; i = nextInCell[i]) {
+                if (cities[i].x >= x0 && cities[i].x <= x1 &&
+                    cities[i].y >= y0 && cities[i].y <= y1)
+                    out[found++] = i;
+            }
+        }
+    }
+    return found;
+}
@@ -0,0 +1,17 @@
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+/* Uniform-grid spatial index over the located cities.
+   Bulk-built from cities[]; new locations inside the grid are inserted
+   in place, anything else (deletions, renumbering, points outside the
+   grid) marks it dirty and it is rebuilt on the next query. */
+
+#define GRID_DIM 16      /* max cells per axis */
+
+void spatialOnCityLocated(int idx);
+void spatialInvalidate(void);
+
+int nearestCities(double x, double y, int k, int out[]);
+int citiesInRect(double x0, double y0, double x1, double y1, int out[]);
+
+#endif
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "graph.h"
+#include "algorithms.h"
+#include "route.h"
+#include "compact.h"
+#include "fuzzy.h"
+#include "sssp.h"
+
+#define INF INT_MAX
+
+/* ------------------ sequential reference ------------------ */
+
+static void storeDistance(int city, int dist, void* ctx) {
+    ((int*)ctx)[city] = dist;
+}
+
+/* plain Dijkstra over every city; unreached cities get UNREACHABLE */
+void dijkstraAllDistances(const RouteGraph* g, int source, int dist[]) {
+    SearchWorkspace ws;
+    initWorkspace(&ws);
+
+    for (int v = 0; v < g->cityCount; v++) dist[v] = UNREACHABLE;
+    rangeQuery(g, &ws, &source, 1, INF - 1, storeDistance, dist);
+}
+
+/* ------------------ parallel delta-stepping ------------------ */
+
+/* lower *target to nd; returns 1 if this call improved it */
+static int atomicMin(int* target, int nd) {
+    int old = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (nd < old) {
+        if (__atomic_compare_exchange_n(target, &old, nd, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return 1;
+    }
+    return 0;
+}
+
+/* relax the light (w <= delta) or heavy (w > delta) roads of every city
+   in list[]; cities lowered into bucket `bucket` are flagged in changed[] */
+static void relaxRoads(const CompactGraph* g, const int list[], int count, int delta,
+                       int heavy, int bucket, int dist[], int changed[]) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4)
+#endif
+    for (int i = 0; i < count; i++) {
+        int u = list[i];
+        int du = __atomic_load_n(&dist[u], __ATOMIC_RELAXED);
+        CompactCursor cur;
+        int v, w;
+
+        compactBegin(&cur, g, u);
+        while (compactNext(&cur, &v, &w)) {
+            if ((w > delta) != heavy) continue;
+            if (atomicMin(&dist[v], du + w) && (du + w) / delta == bucket)
+                __atomic_store_n(&changed[v], 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/* Delta-stepping: cities are processed in distance buckets of width
+   delta. Within a bucket, light roads are relaxed in parallel until the
+   bucket stops changing; heavy roads are relaxed once afterwards.
+   Distances are identical to dijkstraAllDistances(). */
+void deltaSteppingSSSP(const RouteGraph* g, int source, int delta, int dist[]) {
+    int n = g->cityCount;
+    int done[MAX] = {0}, inBucket[MAX] = {0}, changed[MAX] = {0};
+    int frontier[MAX], settled[MAX];
+
+    if (delta < 1) delta = 1;
+    for (int v = 0; v < n; v++) dist[v] = INF;
+    dist[source] = 0;
+
+    while (1) {
+        /* next non-empty bucket */
+        int bucket = -1;
+        for (int v = 0; v < n; v++) {
+            if (!done[v] && dist[v] != INF && (bucket == -1 || dist[v] / delta < bucket))
+                bucket = dist[v] / delta;
+        }
+        if (bucket == -1) break;
+
+        int frontierCount = 0, settledCount = 0;
+        for (int v = 0; v < n; v++) {
+            if (!done[v] && dist[v] != INF && dist[v] / delta == bucket) frontier[frontierCount++] = v;
+        }
+
+        /* light phase: repeat while relaxations land back in this bucket */
+        while (frontierCount > 0) {
+            for (int i = 0; i < frontierCount; i++) {
+                int v = frontier[i];
+                if (!inBucket[v]) {
+                    inBucket[v] = 1;
+                    settled[settledCount++] = v;
+                }
+            }
+            relaxRoads(&g->adj, frontier, frontierCount, delta, 0, bucket, dist, changed);
+
+            frontierCount = 0;
+            for (int v = 0; v < n; v++) {
+                if (changed[v]) {
+                    changed[v] = 0;
+                    frontier[frontierCount++] = v;
+                }
+            }
+        }
+
+        /* heavy phase: once, from the final distances of the bucket */
+        relaxRoads(&g->adj, settled, settledCount, delta, 1, bucket, dist, changed);
+        for (int i = 0; i < settledCount; i++) done[settled[i]] = 1;
+        for (int v = 0; v < n; v++) changed[v] = 0;
+    }
+
+    for (int v = 0; v < n; v++) {
+        if (dist[v] == INF) dist[v] = UNREACHABLE;
+    }
+}
+
+/* ------------------ menu front-end ------------------ */
+
+void showDistanceField(const char* start, int delta) {
+    const RouteGraph* g = currentRouteGraph();
+    int s = resolveRouteCity(g, start);
+    if (s == -1) {
+        printf("Invalid city name.\n");
+        return;
+    }
+
+    if (delta <= 0) {
+        /* default: the average road length */
+        int totalCities, totalRoads, mostIdx;
+        double avgDist;
+        getGraphStats(&totalCities, &totalRoads, &avgDist, &mostIdx);
+        delta = avgDist >= 1.0 ? (int)avgDist : 1;
+    }
+
+    int dist[MAX];
+    deltaSteppingSSSP(g, s, delta, dist);
+
+    printf("\nDistances from %s (delta-stepping, delta = %d km", g->names[s], delta);
+#ifdef _OPENMP
+    printf(", %d threads", omp_get_max_threads());
+#endif
+    printf("):\n");
+
+    for (int v = 0; v < g->cityCount; v++) {
+        if (dist[v] == UNREACHABLE) printf("  %-*s unreachable\n", NAME_LEN, g->names[v]);
+        else printf("  %-*s %d km\n", NAME_LEN, g->names[v], dist[v]);
+    }
+
+#ifdef SSSP_CHECK
+    /* debug builds (-DSSSP_CHECK): cross-check against sequential Dijkstra */
+    int reference[MAX];
+    dijkstraAllDistances(g, s, reference);
+    for (int v = 0; v < g->cityCount; v++) {
+        if (dist[v] != reference[v])
+            fprintf(stderr, "sssp: %s is %d km by delta-stepping, %d km by Dijkstra\n",
+                    g->names[v], dist[v], reference[v]);
+    }
+#endif
+}
@@ -0,0 +1,15 @@
+#ifndef SSSP_H
+#define SSSP_H
+
+#include "graph.h"
+#include "route.h"
+
+/* One-to-all shortest path distances (distance fields). */
+
+#define UNREACHABLE -1
+
+void dijkstraAllDistances(const RouteGraph* g, int source, int dist[]);
+void deltaSteppingSSSP(const RouteGraph* g, int source, int delta, int dist[]);
+void showDistanceField(const char* start, int delta);
+
+#endif
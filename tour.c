@@ -0,0 +1,223 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L   // clock_gettime() under strict -std=c99
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#ifdef _WIN32
+#include <windows.h>  // QueryPerformanceCounter()
+#else
+#include <time.h>     // clock_gettime()
+#endif
+
+#include "graph.h"
+#include "algorithms.h"
+#include "route.h"
+#include "tour.h"
+
+/* ------------------ helpers ------------------ */
+
+/* monotonic wall-clock time; clock() would count CPU time of all threads */
+static double wallClockMs(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+/* stop after position j of the tour; -1 past the end of an open tour */
+static int nextStop(const int order[], int k, int j, int roundTrip) {
+    if (j + 1 < k) return order[j + 1];
+    return roundTrip ? order[0] : -1;
+}
+
+static int legCost(int matrix[][MAX], int a, int b) {
+    return b < 0 ? 0 : matrix[a][b];
+}
+
+/* one independent one-to-all search per stop */
+static void buildMatrix(const RouteGraph* g, const int stops[], int k, int matrix[][MAX]) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < k; i++) {
+        SearchWorkspace ws;
+        initWorkspace(&ws);
+        routeSearchAll(g, stops[i], &ws);
+        for (int j = 0; j < k; j++) matrix[i][j] = workspaceDist(&ws, stops[j]);
+    }
+}
+
+static void nearestNeighbourTour(int matrix[][MAX], int k, int order[]) {
+    int used[MAX] = {0};
+    order[0] = 0;
+    used[0] = 1;
+
+    for (int pos = 1; pos < k; pos++) {
+        int best = -1;
+        for (int j = 0; j < k; j++) {
+            if (!used[j] && (best == -1 || matrix[order[pos - 1]][j] < matrix[order[pos - 1]][best]))
+                best = j;
+        }
+        order[pos] = best;
+        used[best] = 1;
+    }
+}
+
+/* reverse order[i..j] when that shortens the tour */
+static int twoOptPass(int matrix[][MAX], int order[], int k, int roundTrip, double deadline) {
+    int improved = 0;
+    for (int i = 1; i < k - 1 && wallClockMs() < deadline; i++) {
+        for (int j = i + 1; j < k; j++) {
+            int p = order[i - 1];
+            int n = nextStop(order, k, j, roundTrip);
+            int delta = matrix[p][order[j]] + legCost(matrix, order[i], n)
+                      - matrix[p][order[i]] - legCost(matrix, order[j], n);
+            if (delta >= 0) continue;
+
+            for (int a = i, b = j; a < b; a++, b--) {
+                int t = order[a];
+                order[a] = order[b];
+                order[b] = t;
+            }
+            improved = 1;
+        }
+    }
+    return improved;
+}
+
+/* move a run of 1-3 stops to the cheapest other gap in the tour */
+static int orOptPass(int matrix[][MAX], int order[], int k, int roundTrip, double deadline) {
+    int improved = 0;
+    for (int len = 1; len <= 3; len++) {
+        for (int i = 1; i + len <= k && wallClockMs() < deadline; i++) {
+            int first = order[i], last = order[i + len - 1];
+            int prev = order[i - 1];
+            int next = nextStop(order, k, i + len - 1, roundTrip);
+            int gain = matrix[prev][first] + legCost(matrix, last, next) - legCost(matrix, prev, next);
+
+            int bestPos = -1, bestCost = gain;
+            for (int p = 0; p < k; p++) {
+                if (p >= i - 1 && p <= i + len - 1) continue;
+                int a = order[p];
+                int b = nextStop(order, k, p, roundTrip);
+                int cost = matrix[a][first] + legCost(matrix, last, b) - legCost(matrix, a, b);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestPos = p;
+                }
+            }
+            if (bestPos == -1) continue;
+
+            int moved[MAX], n = 0;
+            for (int x = 0; x < k; x++) {
+                if (x >= i && x < i + len) continue;
+                moved[n++] = order[x];
+                if (x == bestPos) {
+                    for (int s = 0; s < len; s++) moved[n++] = order[i + s];
+                }
+            }
+            memcpy(order, moved, k * sizeof(int));
+            improved = 1;
+        }
+    }
+    return improved;
+}
+
+/* ------------------ planning ------------------ */
+
+/* Choose a visiting order for stops[] (stops[0] stays first) and expand
+   it into a full city path. Like routeQuery, touches nothing but g, tw,
+   order and out. Returns 1, TOUR_UNREACHABLE if some stop cannot be
+   reached from stops[0], or 0 if the path exceeds MAX_ROUTE_LEN. */
+int planTour(const RouteGraph* g, const int stops[], int stopCount, int roundTrip,
+             TourWorkspace* tw, int order[], RouteResult* out) {
+    int k = stopCount;
+    double deadline = wallClockMs() + TOUR_TIME_BUDGET_MS;
+
+    out->stops = 0;
+    out->total = 0;
+    buildMatrix(g, stops, k, tw->matrix);
+
+    /* roads are two-way, so one row decides reachability for all pairs */
+    for (int j = 1; j < k; j++) {
+        if (tw->matrix[0][j] == INT_MAX) return TOUR_UNREACHABLE;
+    }
+
+    nearestNeighbourTour(tw->matrix, k, order);
+    while (wallClockMs() < deadline) {
+        int improved = twoOptPass(tw->matrix, order, k, roundTrip, deadline);
+        improved |= orOptPass(tw->matrix, order, k, roundTrip, deadline);
+        if (!improved) break;
+    }
+
+    /* expand stop-to-stop legs into roads */
+    RouteResult leg;
+    int legsToRun = roundTrip ? k : k - 1;
+
+    initWorkspace(&tw->search);
+    for (int i = 0; i < legsToRun; i++) {
+        int from = stops[order[i]];
+        int to = stops[order[(i + 1) % k]];
+        if (!routeQuery(g, from, to, ROUTE_SHORTEST, &tw->search, &leg)) return TOUR_UNREACHABLE;
+
+        if (out->stops == 0) out->path[out->stops++] = leg.path[0];
+        if (out->stops + leg.stops - 1 > MAX_ROUTE_LEN) return 0;
+        for (int j = 1; j < leg.stops; j++) {
+            out->legs[out->stops - 1] = leg.legs[j - 1];
+            out->path[out->stops++] = leg.path[j];
+        }
+        out->total += leg.total;
+    }
+    return 1;
+}
+
+/* ------------------ menu front-end ------------------ */
+
+void multiStopTour(const char* stopList, int roundTrip) {
+    static TourWorkspace workspace;
+    static RouteResult tour;
+    const RouteGraph* g = currentRouteGraph();
+    int stops[MAX], order[MAX];
+    int k = parseCityList(g, stopList, stops, MAX);
+    if (k < 0) return;
+    if (k < 2) {
+        printf("Enter at least two different stops.\n");
+        return;
+    }
+
+    double started = wallClockMs();
+    int planned = planTour(g, stops, k, roundTrip, &workspace, order, &tour);
+    if (planned == TOUR_UNREACHABLE) {
+        for (int j = 1; j < k; j++) {
+            if (workspace.matrix[0][j] == INT_MAX) {
+                printf("No route from %s to %s.\n", g->names[stops[0]], g->names[stops[j]]);
+                return;
+            }
+        }
+        printf("Some stops cannot be reached from %s.\n", g->names[stops[0]]);
+        return;
+    }
+    if (!planned) {
+        printf("Tour is too long to expand (more than %d cities).\n", MAX_ROUTE_LEN);
+        return;
+    }
+    double ms = wallClockMs() - started;
+
+    printf("\nVisit Order: ");
+    for (int i = 0; i < k; i++) printf("%s%s", g->names[stops[order[i]]], i < k - 1 ? " -> " : "");
+    if (roundTrip) printf(" -> %s", g->names[stops[order[0]]]);
+    printf("\nPlanned %d stops in %.1f ms\n", k, ms);
+
+    printf("\nMulti-Stop Tour:\n");
+    displayRoute(g, &tour);
+    showRouteSummary(&tour);
+    saveRouteReport(g, roundTrip ? "Multi-stop tour (round trip)" : "Multi-stop tour", &tour);
+}
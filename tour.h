@@ -0,0 +1,24 @@
+#ifndef TOUR_H
+#define TOUR_H
+
+#include "route.h"
+
+/* Multi-stop route optimization (visiting order of a stop list).
+   Stop-to-stop distances come from parallel one-to-all searches; the
+   order is built nearest-neighbour first, then improved with 2-opt and
+   Or-opt moves until no move helps or the time budget runs out. */
+
+#define TOUR_TIME_BUDGET_MS 500
+#define TOUR_UNREACHABLE    -1   /* planTour(): a stop is cut off from stops[0] */
+
+/* caller-owned scratch state for planTour(), one per thread */
+typedef struct TourWorkspace {
+    int matrix[MAX][MAX];      /* km between stops (by position in stops[]) */
+    SearchWorkspace search;    /* for expanding the legs */
+} TourWorkspace;
+
+int planTour(const RouteGraph* g, const int stops[], int stopCount, int roundTrip,
+             TourWorkspace* tw, int order[], RouteResult* out);
+void multiStopTour(const char* stopList, int roundTrip);
+
+#endif
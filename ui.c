@@ -84,7 +84,16 @@ void printMainMenu()
     printf(YELLOW "8. BFS Shortest Path\n" RESET);
     printf(YELLOW "9. Dijkstra Shortest Path\n" RESET);
     printf(YELLOW "10. Suggest City\n" RESET);
-    printf(RED    "11. Save & Exit\n\n" RESET);
+    printf(YELLOW "11. Overlay Route (Traffic Profile)\n" RESET);
+    printf(YELLOW "12. Set Road Traffic Weight\n" RESET);
+    printf(YELLOW "13. Reorder Cities for Locality\n" RESET);
+    printf(YELLOW "14. Cities Within Range\n" RESET);
+    printf(YELLOW "15. Distance Field (Parallel)\n" RESET);
+    printf(YELLOW "16. Set City Location\n" RESET);
+    printf(YELLOW "17. Nearest Cities to a Point\n" RESET);
+    printf(YELLOW "18. Cities in an Area\n" RESET);
+    printf(YELLOW "19. Multi-Stop Tour\n" RESET);
+    printf(RED    "0. Save & Exit\n\n" RESET);
 
     printf(CYAN "Enter your choice: " RESET);
 }